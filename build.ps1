@@ -45,12 +45,14 @@ if ( $compile -or $cleanAndCompile -or $compileAndRun -or $all ) {
         -pedantic-errors `
         -std=c99 `
         -Wno-missing-braces `
+        -ffp-contract=off `
         -I src/include/ `
         -L lib/ `
         -lraylib `
         -lopengl32 `
         -lgdi32 `
-        -lwinmm
+        -lwinmm `
+        -lpthread
 }
 
 # run
@@ -30,6 +30,7 @@ compile_project() {
         -pedantic-errors \
         -std=c99 \
         -Wno-missing-braces \
+        -ffp-contract=off \
         -I src/include/ \
         -lraylib \
         -lGL \
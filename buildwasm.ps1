@@ -46,18 +46,41 @@ if ( $compile -or $cleanAndCompile -or $compileAndRun -or $all ) {
     New-Item -Path ".\$BuildDir" -ItemType Directory > $null
     emcc -o "./$BuildDir/$CompiledFile.html" `
          ./src/Ball.c `
+         ./src/BallBatch.c `
+         ./src/BallMask.c `
+         ./src/BallMotion.c `
+         ./src/BatchSimulation.c `
+         ./src/BinaryIO.c `
+         ./src/Broadphase.c `
+         ./src/ComputerPlayer.c `
+         ./src/ContactSolver.c `
          ./src/CueStick.c `
          ./src/Cushion.c `
+         ./src/Determinism.c `
          ./src/EBPRules.c `
+         ./src/EventSimulation.c `
+         ./src/GameRules.c `
          ./src/GameWindow.c `
          ./src/GameWorld.c `
          ./src/main.c `
+         ./src/NineBallRules.c `
          ./src/Pocket.c `
+         ./src/PositionTrace.c `
+         ./src/Replay.c `
          ./src/ResourceManager.c `
+         ./src/SaveGame.c `
+         ./src/ShotPreview.c `
+         ./src/Simulation.c `
+         ./src/SimulationEvents.c `
+         ./src/Snapshot.c `
+         ./src/SnookerRules.c `
+         ./src/Trajectory.c `
+         ./src/UndoHistory.c `
          -Wall `
          -std=c99 `
          -D_DEFAULT_SOURCE `
          -Wno-missing-braces `
+         -ffp-contract=off `
          -Wunused-result `
          -Os `
          -I. -I./src/include `
@@ -12,46 +12,25 @@
 #include "raylib/raymath.h"
 
 #include "Ball.h"
+#include "CommonMacros.h"
+#ifndef EBP_HEADLESS
 #include "ResourceManager.h"
+#endif
 #include "Types.h"
 
-void updateBall( Ball *b, float delta ) {
+// how far two balls are pushed into each other at the time of impact
+#define BALL_CONTACT_SLOP 0.01f
 
-    b->center.x += b->vel.x * delta;
-    b->center.y += b->vel.y * delta;
-
-    b->vel.x *= b->friction;
-    b->vel.y *= b->friction;
-
-    b->spin.x *= 0.98f;
-    b->spin.y *= 0.98f;
-
-    float speed = sqrtf( b->vel.x * b->vel.x + b->vel.y * b->vel.y );
-    if ( speed < 0.5f ) {  // less than 0.5 pixels/second
-        b->vel = (Vector2) { 0, 0 };
-        b->spin = (Vector2) { 0, 0 };
-        b->moving = false;
-    } else {
-        b->moving = true;
-    }
-
-}
+static CollisionResult ballEdgeCollision( const BallBatch *bb, int i, Vector2 segStart, Vector2 segNorm, Vector2 normal, float segLen );
 
+#ifndef EBP_HEADLESS
 void drawBall( Ball *b ) {
 
     if ( b->pocketed ) {
         return;
     }
 
-    DrawTexturePro( 
-        rm.ballsTexture, 
-        (Rectangle) { 64 * b->number, 0, 64, 64 }, 
-        (Rectangle) { b->center.x - b->radius, b->center.y - b->radius, b->radius * 2, b->radius * 2 },
-        (Vector2) { 0 },
-        0.0f,
-        WHITE
-    );
-
+    drawBallAt( b, b->center, b->radius, WHITE );
     DrawCircleLinesV( b->center, b->radius, BLACK );
 
     /*if ( b->striped ) {
@@ -88,84 +67,67 @@ void drawBall( Ball *b ) {
 
 }
 
-void resolveCollisionBallBall( Ball *b1, Ball *b2 ) {
-
-    // vector between centers
-    Vector2 d = {
-        b2->center.x - b1->center.x,
-        b2->center.y - b1->center.y
-    };
-
-    float distance = Vector2Distance( b1->center, b2->center );
-    float minDistance = b1->radius + b2->radius;
+// the balls without a number (snooker) are plain circles of their color,
+// the others come from the texture
+void drawBallAt( const Ball *b, Vector2 center, float radius, Color tint ) {
 
-    // the balls are not colliding
-    if ( distance >= minDistance ) {
+    if ( b->plain ) {
+        DrawCircleV( center, radius, ColorTint( b->color, tint ) );
+        DrawCircleV( 
+            (Vector2) { center.x - radius * 0.35f, center.y - radius * 0.35f }, 
+            radius * 0.3f, 
+            Fade( WHITE, 0.4f * tint.a / 255.0f )
+        );
         return;
     }
 
-    // normalizing
-    Vector2 norm = {
-        d.x / distance,
-        d.y / distance
-    };
-
-    // important: separate the balls
-    float overlap = minDistance - distance;
-    float separation = overlap / 2.0f;
+    DrawTexturePro( 
+        rm.ballsTexture, 
+        (Rectangle) { 64 * b->number, 0, 64, 64 }, 
+        (Rectangle) { center.x - radius, center.y - radius, radius * 2, radius * 2 },
+        (Vector2) { 0 },
+        0.0f,
+        tint
+    );
 
-    b1->center.x -= separation * norm.x;
-    b1->center.y -= separation * norm.y;
-    b2->center.x += separation * norm.x;
-    b2->center.y += separation * norm.y;
+}
+#endif
 
-    // relative velocity
-    Vector2 v = {
-        b1->vel.x - b2->vel.x,
-        b1->vel.y - b2->vel.y
-    };
+// Check collision between circle and line segment
+CollisionResult ballSegmentCollision( const BallBatch *bb, int i, Vector2 segStart, Vector2 segEnd ) {
 
-    // velocity on normal
-    float dotProduct = Vector2DotProduct( v, norm );
+    Vector2 segDir = Vector2Subtract( segEnd, segStart );
+    float segLen = Vector2Length( segDir );
+    Vector2 segNorm = Vector2Normalize( segDir );
 
-    // do not collide if the balls are moving away
-    if ( dotProduct <= 0 ) {
-        return;
-    }
+    // segment normal (perpendicular, points "outward")
+    Vector2 normal = { segNorm.y, -segNorm.x };
 
-    // transfer momentum (equal mass)
-    b1->vel.x -= dotProduct * norm.x;
-    b1->vel.y -= dotProduct * norm.y;
-    b2->vel.x += dotProduct * norm.x;
-    b2->vel.y += dotProduct * norm.y;
+    return ballEdgeCollision( bb, i, segStart, segNorm, normal, segLen );
 
 }
 
-// Check collision between circle and line segment
-CollisionResult ballSegmentCollision( Ball *b, Vector2 segStart, Vector2 segEnd ) {
+// same as ballSegmentCollision, with the edge direction, normal and length already known
+static CollisionResult ballEdgeCollision( const BallBatch *bb, int i, Vector2 segStart, Vector2 segNorm, Vector2 normal, float segLen ) {
 
     CollisionResult result = { 0 };
 
-    Vector2 movement = Vector2Subtract( b->center, b->prevPos );
+    Vector2 center = { bb->x[i], bb->y[i] };
+    Vector2 prevPos = { bb->px[i], bb->py[i] };
+    float radius = bb->radius[i];
+    Vector2 movement = Vector2Subtract( center, prevPos );
 
     // if there's no movement, there's no sweep collision
     if ( Vector2Length( movement ) < 0.001f ) {
         return result;
     }
 
-    Vector2 segDir = Vector2Subtract( segEnd, segStart );
-    float segLen = Vector2Length( segDir );
-    Vector2 segNorm = Vector2Normalize( segDir );
-
-    // segment normal (perpendicular, points "outward")
-    Vector2 normal = { segNorm.y, -segNorm.x };
-
     // distance from current center to line
-    Vector2 toLineCurr = Vector2Subtract( b->center, segStart );
+    Vector2 toLineCurr = Vector2Subtract( center, segStart );
     float distCurr = Vector2DotProduct( toLineCurr, normal );
 
     // distance from previous center to line
-    Vector2 toLinePrev = Vector2Subtract( b->prevPos, segStart );
+    Vector2 toLinePrev = Vector2Subtract( prevPos, segStart );
     float distPrev = Vector2DotProduct( toLinePrev, normal );
 
     // check if moving away from the line
@@ -174,13 +136,13 @@ CollisionResult ballSegmentCollision( Ball *b, Vector2 segStart, Vector2 segEnd
     }
 
     // check if will collide this frame
-    if ( distCurr > b->radius || distPrev < -b->radius ) {
+    if ( distCurr > radius || distPrev < -radius ) {
         return result; // too far away
     }
 
     // calculate t (when the circle touches the line)
     float distChange = distCurr - distPrev;
-    float t = ( distPrev - b->radius ) / -distChange;
+    float t = ( distPrev - radius ) / -distChange;
 
     // clamp t between 0 and 1
     if ( t < 0.0f ) {
@@ -191,7 +153,7 @@ CollisionResult ballSegmentCollision( Ball *b, Vector2 segStart, Vector2 segEnd
     }
 
     // center position at collision moment
-    Vector2 collisionCenter = Vector2Add( b->prevPos, Vector2Scale( movement, t ) );
+    Vector2 collisionCenter = Vector2Add( prevPos, Vector2Scale( movement, t ) );
 
     // projection on segment
     Vector2 toCollision = Vector2Subtract( collisionCenter, segStart );
@@ -201,7 +163,7 @@ CollisionResult ballSegmentCollision( Ball *b, Vector2 segStart, Vector2 segEnd
     if ( projection >= -0.1f && projection <= segLen + 0.1f ) {
         result.hasCollision = true;
         result.t = t;
-        result.point = Vector2Add( collisionCenter, Vector2Scale( normal, -b->radius ) );
+        result.point = Vector2Add( collisionCenter, Vector2Scale( normal, -radius ) );
         result.normal = normal;
     }
 
@@ -210,16 +172,18 @@ CollisionResult ballSegmentCollision( Ball *b, Vector2 segStart, Vector2 segEnd
 }
 
 // collision of moving circle with a point (vertex)
-CollisionResult ballPointSweep( Ball *b, Vector2 point ) {
+CollisionResult ballPointSweep( const BallBatch *bb, int i, Vector2 point ) {
 
     CollisionResult result = { 0 };
 
-    Vector2 movement = Vector2Subtract( b->center, b->prevPos );
-    Vector2 toPoint = Vector2Subtract( point, b->prevPos );
+    Vector2 prevPos = { bb->px[i], bb->py[i] };
+    float radius = bb->radius[i];
+    Vector2 movement = Vector2Subtract( (Vector2) { bb->x[i], bb->y[i] }, prevPos );
+    Vector2 toPoint = Vector2Subtract( point, prevPos );
 
     float aC = Vector2DotProduct( movement, movement );
     float bC = -2.0f * Vector2DotProduct( movement, toPoint );
-    float cC = Vector2DotProduct( toPoint, toPoint ) - b->radius * b->radius;
+    float cC = Vector2DotProduct( toPoint, toPoint ) - radius * radius;
 
     float discriminant = bC * bC - 4 * aC * cC;
 
@@ -231,12 +195,12 @@ CollisionResult ballPointSweep( Ball *b, Vector2 point ) {
 
     if ( t >= 0 && t <= 1 ) {
 
-        Vector2 collisionCenter = Vector2Add( b->prevPos, Vector2Scale( movement, t ) );
+        Vector2 collisionCenter = Vector2Add( prevPos, Vector2Scale( movement, t ) );
         Vector2 normal = Vector2Normalize( Vector2Subtract( collisionCenter, point ) );
 
         result.hasCollision = true;
         result.t = t;
-        result.point = Vector2Add( point, Vector2Scale( normal, b->radius ) );
+        result.point = Vector2Add( point, Vector2Scale( normal, radius ) );
         result.normal = normal;
 
     }
@@ -245,8 +209,66 @@ CollisionResult ballPointSweep( Ball *b, Vector2 point ) {
 
 }
 
+// first contact between two moving balls, each going from prevPos to center
+// in the same time span. They are taken to a distance slightly smaller than
+// the sum of the radii, since the response only acts on overlapping balls.
+// Overlapping balls collide at t = 0 while they are still approaching.
+CollisionResult ballBallSweep( const BallBatch *bb, int a, int b ) {
+
+    CollisionResult result = { 0 };
+
+    Vector2 prevPos1 = { bb->px[a], bb->py[a] };
+    Vector2 prevPos2 = { bb->px[b], bb->py[b] };
+    Vector2 center1 = { bb->x[a], bb->y[a] };
+    Vector2 start = Vector2Subtract( prevPos2, prevPos1 );
+    Vector2 movement = Vector2Subtract(
+        Vector2Subtract( (Vector2) { bb->x[b], bb->y[b] }, prevPos2 ),
+        Vector2Subtract( center1, prevPos1 )
+    );
+
+    float approach = Vector2DotProduct( start, movement );
+
+    // apart or not moving towards each other
+    if ( approach >= 0 ) {
+        return result;
+    }
+
+    float contact = bb->radius[a] + bb->radius[b] - BALL_CONTACT_SLOP;
+    float aC = Vector2DotProduct( movement, movement );
+    float bC = 2.0f * approach;
+    float cC = Vector2DotProduct( start, start ) - contact * contact;
+    float t = 0.0f;
+
+    if ( cC > 0 ) {
+
+        float discriminant = bC * bC - 4 * aC * cC;
+
+        if ( discriminant < 0 ) {
+            return result;
+        }
+
+        t = ( -bC - sqrtf( discriminant ) ) / ( 2.0f * aC );
+
+        if ( t > 1 ) {
+            return result;
+        }
+
+    }
+
+    Vector2 normal = Vector2Normalize( Vector2Add( start, Vector2Scale( movement, t ) ) );
+    Vector2 b1Center = Vector2Lerp( prevPos1, center1, t );
+
+    result.hasCollision = true;
+    result.t = t;
+    result.point = Vector2Add( b1Center, Vector2Scale( normal, bb->radius[a] ) );
+    result.normal = normal;
+
+    return result;
+
+}
+
 // calculate collision between a ball and a convex polygon
-CollisionResult ballConvexCollision( Ball *b, Vector2* vertices, int numVertices ) {
+CollisionResult ballConvexCollision( const BallBatch *bb, int index, Vector2* vertices, int numVertices ) {
 
     CollisionResult earliestCollision = { 0 };
     float minT = INFINITY;
@@ -257,7 +279,7 @@ CollisionResult ballConvexCollision( Ball *b, Vector2* vertices, int numVertices
         Vector2 start = vertices[i];
         Vector2 end = vertices[(i + 1) % numVertices];
 
-        CollisionResult collision = ballSegmentCollision( b, start, end );
+        CollisionResult collision = ballSegmentCollision( bb, index, start, end );
 
         if ( collision.hasCollision && collision.t < minT ) {
             minT = collision.t;
@@ -270,7 +292,7 @@ CollisionResult ballConvexCollision( Ball *b, Vector2* vertices, int numVertices
     if ( !earliestCollision.hasCollision ) {
         for ( int i = 0; i < numVertices; i++ ) {
 
-            CollisionResult collision = ballPointSweep( b, vertices[i] );
+            CollisionResult collision = ballPointSweep( bb, index, vertices[i] );
 
             if ( collision.hasCollision && collision.t < minT ) {
                 minT = collision.t;
@@ -285,15 +307,55 @@ CollisionResult ballConvexCollision( Ball *b, Vector2* vertices, int numVertices
 
 }
 
-CollisionResult ballCushionCollision( Ball *b, Cushion *c ) {
-    return ballConvexCollision( b, c->vertices, 4 );
+// ballConvexCollision using the baked cushion geometry
+CollisionResult ballCushionCollision( const BallBatch *bb, int index, Cushion *c ) {
+
+    CollisionResult earliestCollision = { 0 };
+
+    // early out: swept bounds of the ball far from the cushion
+    float r = bb->radius[index];
+    if ( fminf( bb->px[index], bb->x[index] ) - r > c->bounds.x + c->bounds.width ||
+         fmaxf( bb->px[index], bb->x[index] ) + r < c->bounds.x ||
+         fminf( bb->py[index], bb->y[index] ) - r > c->bounds.y + c->bounds.height ||
+         fmaxf( bb->py[index], bb->y[index] ) + r < c->bounds.y ) {
+        return earliestCollision;
+    }
+
+    float minT = INFINITY;
+
+    for ( int i = 0; i < 4; i++ ) {
+
+        CollisionResult collision = ballEdgeCollision( bb, index, c->vertices[i], c->edgeDirections[i], c->edgeNormals[i], c->edgeLengths[i] );
+
+        if ( collision.hasCollision && collision.t < minT ) {
+            minT = collision.t;
+            earliestCollision = collision;
+        }
+
+    }
+
+    if ( !earliestCollision.hasCollision ) {
+        for ( int i = 0; i < 4; i++ ) {
+
+            CollisionResult collision = ballPointSweep( bb, index, c->vertices[i] );
+
+            if ( collision.hasCollision && collision.t < minT ) {
+                minT = collision.t;
+                earliestCollision = collision;
+            }
+
+        }
+    }
+
+    return earliestCollision;
+
 }
 
 void performDefaultBallPositioning( Ball *balls, int radius, Rectangle boundarie ) {
 
     int k = 1;
     for ( int i = 0; i < 5; i++ ) {
-        float iniY = GetScreenHeight() / 2 - radius * i;
+        float iniY = boundarie.y + boundarie.height / 2 - radius * i;
         for ( int j = 0; j <= i; j++ ) {
             balls[k].center = (Vector2) {
                 boundarie.x + boundarie.width - boundarie.width / 4 + ( radius * 2 ) * i - 2.5f * i, 
@@ -308,13 +370,20 @@ void performDefaultBallPositioning( Ball *balls, int radius, Rectangle boundarie
 
 void performTestBallPositioning( Ball *balls, int radius, Rectangle boundarie ) {
 
-    balls[1].center = (Vector2) { 100, 100 };
-    balls[8].center = (Vector2) { GetScreenWidth() / 2, 100 };
-    balls[2].center = (Vector2) { GetScreenWidth() - 100, 100 };
+    float left = boundarie.x;
+    float right = boundarie.x + boundarie.width;
+    float top = boundarie.y;
+    float bottom = boundarie.y + boundarie.height;
+    float centerX = boundarie.x + boundarie.width / 2;
+    float centerY = boundarie.y + boundarie.height / 2;
+
+    balls[1].center = (Vector2) { left, top };
+    balls[8].center = (Vector2) { centerX, top };
+    balls[2].center = (Vector2) { right, top };
 
-    balls[9].center = (Vector2) { 100, GetScreenHeight() - 100 };
-    balls[10].center = (Vector2) { GetScreenWidth() / 2, GetScreenHeight() - 100 };
-    balls[11].center = (Vector2) { GetScreenWidth() - 100, GetScreenHeight() - 100 };
+    balls[9].center = (Vector2) { left, bottom };
+    balls[10].center = (Vector2) { centerX, bottom };
+    balls[11].center = (Vector2) { right, bottom };
 
     int m = 0;
     int missing[] = { 3, 4, 5, 6, 7, 12, 13, 14, 15 };
@@ -322,7 +391,7 @@ void performTestBallPositioning( Ball *balls, int radius, Rectangle boundarie )
     for ( int i = 1; i <= 15; i++ ) {
         if ( m < 9 ) {
             int p = missing[m];
-            balls[p].center = (Vector2) { GetScreenWidth() / 2 + 30 * (m+2), GetScreenHeight() / 2 };
+            balls[p].center = (Vector2) { centerX + 30 * (m+2), centerY };
             m++;
         }
         balls[i].prevPos = balls[i].center;
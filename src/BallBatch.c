@@ -0,0 +1,191 @@
+/**
+ * @file BallBatch.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Structure of arrays ball integration implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdbool.h>
+
+#if defined( __AVX__ ) || defined( __SSE2__ )
+#include <immintrin.h>
+#endif
+
+#include "raylib/raylib.h"
+
+#include "BallBatch.h"
+#include "CommonMacros.h"
+#include "Types.h"
+
+// squared stop speed
+#define STOP_SPEED_SQR ( BALL_STOP_SPEED * BALL_STOP_SPEED )
+
+static void storeBall( const BallBatch *bb, Ball *b, int i );
+
+void loadBallBatch( BallBatch *bb, const Ball *balls, int count ) {
+
+    for ( int i = 0; i < count; i++ ) {
+        const Ball *b = &balls[i];
+        bb->x[i] = b->center.x;
+        bb->y[i] = b->center.y;
+        bb->px[i] = b->prevPos.x;
+        bb->py[i] = b->prevPos.y;
+        bb->vx[i] = b->vel.x;
+        bb->vy[i] = b->vel.y;
+        bb->sx[i] = b->spin.x;
+        bb->sy[i] = b->spin.y;
+        bb->radius[i] = (float) b->radius;
+        bb->moving[i] = b->moving ? -1 : 0;
+        bb->pocketed[i] = b->pocketed;
+    }
+
+    // lanes past the last ball up to the end of its vector don't move
+    int lanes = ( count + 7 ) & ~7;
+
+    for ( int i = count; i < lanes; i++ ) {
+        bb->x[i] = bb->y[i] = 0.0f;
+        bb->px[i] = bb->py[i] = 0.0f;
+        bb->vx[i] = bb->vy[i] = 0.0f;
+        bb->sx[i] = bb->sy[i] = 0.0f;
+        bb->radius[i] = 0.0f;
+        bb->moving[i] = 0;
+        bb->pocketed[i] = true;
+    }
+
+}
+
+void storeBallBatch( const BallBatch *bb, Ball *balls, int count ) {
+    for ( int i = 0; i < count; i++ ) {
+        storeBall( bb, &balls[i], i );
+    }
+}
+
+Ball ballFromBatch( const BallBatch *bb, const Ball *balls, int index ) {
+    Ball b = balls[index];
+    storeBall( bb, &b, index );
+    return b;
+}
+
+static void storeBall( const BallBatch *bb, Ball *b, int i ) {
+    b->center = (Vector2) { bb->x[i], bb->y[i] };
+    b->prevPos = (Vector2) { bb->px[i], bb->py[i] };
+    b->vel = (Vector2) { bb->vx[i], bb->vy[i] };
+    b->spin = (Vector2) { bb->sx[i], bb->sy[i] };
+    b->moving = bb->moving[i] != 0;
+    b->pocketed = bb->pocketed[i];
+}
+
+#if defined( __AVX__ )
+
+// 16 byte aligned lanes: the 8 wide vectors are loaded unaligned
+void integrateBallBatch( BallBatch *bb, int count, float delta, float velDecay, float spinDecay ) {
+
+    __m256 vDelta = _mm256_set1_ps( delta );
+    __m256 vVelDecay = _mm256_set1_ps( velDecay );
+    __m256 vSpinDecay = _mm256_set1_ps( spinDecay );
+    __m256 vStop = _mm256_set1_ps( STOP_SPEED_SQR );
+
+    for ( int i = 0; i < count; i += 8 ) {
+
+        // all ones where the ball moves, the others keep their state
+        __m256 awake = _mm256_castsi256_ps( _mm256_loadu_si256( (__m256i*) &bb->moving[i] ) );
+        __m256 vx = _mm256_loadu_ps( &bb->vx[i] );
+        __m256 vy = _mm256_loadu_ps( &bb->vy[i] );
+        __m256 sx = _mm256_loadu_ps( &bb->sx[i] );
+        __m256 sy = _mm256_loadu_ps( &bb->sy[i] );
+
+        _mm256_storeu_ps( &bb->x[i], _mm256_add_ps( _mm256_loadu_ps( &bb->x[i] ), _mm256_and_ps( _mm256_mul_ps( vx, vDelta ), awake ) ) );
+        _mm256_storeu_ps( &bb->y[i], _mm256_add_ps( _mm256_loadu_ps( &bb->y[i] ), _mm256_and_ps( _mm256_mul_ps( vy, vDelta ), awake ) ) );
+
+        __m256 nvx = _mm256_mul_ps( vx, vVelDecay );
+        __m256 nvy = _mm256_mul_ps( vy, vVelDecay );
+        __m256 nsx = _mm256_mul_ps( sx, vSpinDecay );
+        __m256 nsy = _mm256_mul_ps( sy, vSpinDecay );
+
+        // all ones where the ball keeps moving
+        __m256 speedSqr = _mm256_add_ps( _mm256_mul_ps( nvx, nvx ), _mm256_mul_ps( nvy, nvy ) );
+        __m256 moving = _mm256_and_ps( _mm256_cmp_ps( speedSqr, vStop, _CMP_GE_OQ ), awake );
+
+        _mm256_storeu_ps( &bb->vx[i], _mm256_or_ps( _mm256_and_ps( nvx, moving ), _mm256_andnot_ps( awake, vx ) ) );
+        _mm256_storeu_ps( &bb->vy[i], _mm256_or_ps( _mm256_and_ps( nvy, moving ), _mm256_andnot_ps( awake, vy ) ) );
+        _mm256_storeu_ps( &bb->sx[i], _mm256_or_ps( _mm256_and_ps( nsx, moving ), _mm256_andnot_ps( awake, sx ) ) );
+        _mm256_storeu_ps( &bb->sy[i], _mm256_or_ps( _mm256_and_ps( nsy, moving ), _mm256_andnot_ps( awake, sy ) ) );
+        _mm256_storeu_si256( (__m256i*) &bb->moving[i], _mm256_castps_si256( moving ) );
+
+    }
+
+}
+
+#elif defined( __SSE2__ )
+
+void integrateBallBatch( BallBatch *bb, int count, float delta, float velDecay, float spinDecay ) {
+
+    __m128 vDelta = _mm_set1_ps( delta );
+    __m128 vVelDecay = _mm_set1_ps( velDecay );
+    __m128 vSpinDecay = _mm_set1_ps( spinDecay );
+    __m128 vStop = _mm_set1_ps( STOP_SPEED_SQR );
+
+    for ( int i = 0; i < count; i += 4 ) {
+
+        // all ones where the ball moves, the others keep their state
+        __m128 awake = _mm_castsi128_ps( _mm_load_si128( (__m128i*) &bb->moving[i] ) );
+        __m128 vx = _mm_load_ps( &bb->vx[i] );
+        __m128 vy = _mm_load_ps( &bb->vy[i] );
+        __m128 sx = _mm_load_ps( &bb->sx[i] );
+        __m128 sy = _mm_load_ps( &bb->sy[i] );
+
+        _mm_store_ps( &bb->x[i], _mm_add_ps( _mm_load_ps( &bb->x[i] ), _mm_and_ps( _mm_mul_ps( vx, vDelta ), awake ) ) );
+        _mm_store_ps( &bb->y[i], _mm_add_ps( _mm_load_ps( &bb->y[i] ), _mm_and_ps( _mm_mul_ps( vy, vDelta ), awake ) ) );
+
+        __m128 nvx = _mm_mul_ps( vx, vVelDecay );
+        __m128 nvy = _mm_mul_ps( vy, vVelDecay );
+        __m128 nsx = _mm_mul_ps( sx, vSpinDecay );
+        __m128 nsy = _mm_mul_ps( sy, vSpinDecay );
+
+        // all ones where the ball keeps moving
+        __m128 speedSqr = _mm_add_ps( _mm_mul_ps( nvx, nvx ), _mm_mul_ps( nvy, nvy ) );
+        __m128 moving = _mm_and_ps( _mm_cmpge_ps( speedSqr, vStop ), awake );
+
+        _mm_store_ps( &bb->vx[i], _mm_or_ps( _mm_and_ps( nvx, moving ), _mm_andnot_ps( awake, vx ) ) );
+        _mm_store_ps( &bb->vy[i], _mm_or_ps( _mm_and_ps( nvy, moving ), _mm_andnot_ps( awake, vy ) ) );
+        _mm_store_ps( &bb->sx[i], _mm_or_ps( _mm_and_ps( nsx, moving ), _mm_andnot_ps( awake, sx ) ) );
+        _mm_store_ps( &bb->sy[i], _mm_or_ps( _mm_and_ps( nsy, moving ), _mm_andnot_ps( awake, sy ) ) );
+        _mm_store_si128( (__m128i*) &bb->moving[i], _mm_castps_si128( moving ) );
+
+    }
+
+}
+
+#else
+
+void integrateBallBatch( BallBatch *bb, int count, float delta, float velDecay, float spinDecay ) {
+
+    for ( int i = 0; i < count; i++ ) {
+
+        if ( !bb->moving[i] ) {
+            continue;
+        }
+
+        bb->x[i] += bb->vx[i] * delta;
+        bb->y[i] += bb->vy[i] * delta;
+
+        bb->vx[i] *= velDecay;
+        bb->vy[i] *= velDecay;
+        bb->sx[i] *= spinDecay;
+        bb->sy[i] *= spinDecay;
+
+        bool moving = bb->vx[i] * bb->vx[i] + bb->vy[i] * bb->vy[i] >= STOP_SPEED_SQR;
+
+        if ( !moving ) {
+            bb->vx[i] = bb->vy[i] = 0.0f;
+            bb->sx[i] = bb->sy[i] = 0.0f;
+        }
+
+        bb->moving[i] = moving ? -1 : 0;
+
+    }
+
+}
+
+#endif
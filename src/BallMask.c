@@ -0,0 +1,59 @@
+/**
+ * @file BallMask.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Ball set implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "BallMask.h"
+#include "Types.h"
+
+int countBallMask( BallMask mask ) {
+    return __builtin_popcount( mask );
+}
+
+BallMask groupBallMask( BallGroup group ) {
+    switch ( group ) {
+        case BALL_GROUP_SOLID: return SOLID_BALLS_MASK;
+        case BALL_GROUP_STRIPED: return STRIPED_BALLS_MASK;
+        default: return 0;
+    }
+}
+
+BallMask opponentGroupBallMask( BallGroup group ) {
+    switch ( group ) {
+        case BALL_GROUP_SOLID: return STRIPED_BALLS_MASK;
+        case BALL_GROUP_STRIPED: return SOLID_BALLS_MASK;
+        default: return 0;
+    }
+}
+
+BallMask tableBallMask( const Ball *balls, int count ) {
+
+    BallMask mask = 0;
+
+    for ( int i = 0; i < count; i++ ) {
+        mask |= (BallMask) !balls[i].pocketed << balls[i].number;
+    }
+
+    return mask;
+
+}
+
+int ballMaskNumbers( BallMask mask, int *numbers ) {
+
+    int count = 0;
+
+    while ( mask != 0 ) {
+        numbers[count++] = __builtin_ctz( mask );
+        mask &= mask - 1;
+    }
+
+    return count;
+
+}
+
+BallMask lowestBallMask( BallMask mask ) {
+    return (BallMask) ( mask & -mask );
+}
@@ -0,0 +1,111 @@
+/**
+ * @file BallMotion.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Analytic ball motion implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+
+#include "BallMotion.h"
+#include "CommonMacros.h"
+#include "Determinism.h"
+#include "Types.h"
+
+float ballDecayRate( const Ball *b ) {
+    return (float) -portableLog( b->friction ) * BALL_DECAY_RATE;
+}
+
+float ballSpinDecayRate( void ) {
+    return (float) -portableLog( BALL_SPIN_DECAY ) * BALL_DECAY_RATE;
+}
+
+float ballTimeToStop( const Ball *b ) {
+
+    float speed = Vector2Length( b->vel );
+
+    if ( speed <= BALL_STOP_SPEED ) {
+        return 0.0f;
+    }
+
+    return (float) portableLog( speed / BALL_STOP_SPEED ) / ballDecayRate( b );
+
+}
+
+float ballStopDisplacement( const Ball *b ) {
+
+    float speed = Vector2Length( b->vel );
+
+    if ( speed <= BALL_STOP_SPEED ) {
+        return 0.0f;
+    }
+
+    return ( 1.0f - BALL_STOP_SPEED / speed ) / ballDecayRate( b );
+
+}
+
+float ballStopDistance( const Ball *b, float speed ) {
+    return speed > BALL_STOP_SPEED ? ( speed - BALL_STOP_SPEED ) / ballDecayRate( b ) : 0.0f;
+}
+
+float ballTimeForDisplacement( const Ball *b, float s ) {
+    float k = ballDecayRate( b );
+    return (float) -portableLog( 1.0f - k * s ) / k;
+}
+
+Vector2 ballRestPoint( const Ball *b ) {
+    return Vector2Add( b->center, Vector2Scale( b->vel, ballStopDisplacement( b ) ) );
+}
+
+BallMotionState ballMotionAt( const Ball *b, float t ) {
+
+    if ( t >= ballTimeToStop( b ) ) {
+        return (BallMotionState) {
+            .center = ballRestPoint( b ),
+            .moving = false
+        };
+    }
+
+    float k = ballDecayRate( b );
+    float velDecay = (float) portableExp( -k * t );
+    float spinDecay = (float) portableExp( -ballSpinDecayRate() * t );
+
+    return (BallMotionState) {
+        .center = Vector2Add( b->center, Vector2Scale( b->vel, ( 1.0f - velDecay ) / k ) ),
+        .vel = Vector2Scale( b->vel, velDecay ),
+        .spin = Vector2Scale( b->spin, spinDecay ),
+        .moving = true
+    };
+
+}
+
+float firstContactDisplacement( Vector2 d0, Vector2 v, float distance ) {
+
+    float a = Vector2DotProduct( v, v );
+    float b = -2.0f * Vector2DotProduct( d0, v );
+    float c = Vector2DotProduct( d0, d0 ) - distance * distance;
+
+    // not getting closer
+    if ( a == 0.0f || b >= 0.0f ) {
+        return INFINITY;
+    }
+
+    // already in contact
+    if ( c <= 0.0f ) {
+        return 0.0f;
+    }
+
+    float discriminant = b * b - 4.0f * a * c;
+
+    if ( discriminant < 0.0f ) {
+        return INFINITY;
+    }
+
+    return ( -b - sqrtf( discriminant ) ) / ( 2.0f * a );
+
+}
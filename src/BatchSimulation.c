@@ -0,0 +1,360 @@
+/**
+ * @file BatchSimulation.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Multithreaded batch shot simulation implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <pthread.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "raylib/raylib.h"
+
+#include "BatchSimulation.h"
+#include "CommonMacros.h"
+#include "Determinism.h"
+#include "EventSimulation.h"
+#include "GameRules.h"
+#include "Simulation.h"
+#include "Types.h"
+
+// steps between two tests for a shot with only friction left
+#define QUIET_CHECK_INTERVAL 16
+
+typedef struct BatchJob {
+    const GameWorld *source;
+    const ShotParams *shots;
+    ShotOutcome *outcomes;
+    int count;
+    int next;               // next shot to be taken, shared by the workers
+} BatchJob;
+
+typedef struct BatchWorker {
+    struct BatchWorkerPool *pool;
+    pthread_t thread;
+    GameWorld *world;       // restored from the source before each shot
+} BatchWorker;
+
+typedef struct BatchWorkerPool {
+    BatchWorker workers[BATCH_SIMULATION_MAX_THREADS];
+    int workerCount;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;    // a batch was posted or the pool is stopping
+    pthread_cond_t idle;    // the last worker left the batch
+    BatchJob *job;          // batch being played, NULL between batches
+    int batch;              // number of the last batch posted
+    int active;             // workers playing the batch
+    bool quit;
+} BatchWorkerPool;
+
+// the simulator behind simulateShotsBatch, started by its first batch
+static BatchSimulator defaultSimulator;
+static pthread_once_t defaultSimulatorOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t defaultSimulatorLock = PTHREAD_MUTEX_INITIALIZER;
+
+static void setupDefaultBatchSimulator( void );
+static void *batchWorker( void *data );
+static void runBatchJob( BatchJob *job, GameWorld *gw );
+static void strikeShot( GameWorld *gw, const ShotParams *shot );
+static int scoreLead( const GameWorld *gw, const CueStick *cs );
+static void judgeShot( GameWorld *gw, CueStick *shooter, int lead, int steps, ShotOutcome *outcome );
+
+int getProcessorCount( void ) {
+
+#ifdef _WIN32
+    int count = pthread_num_processors_np();
+#else
+    int count = (int) sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+
+    return count > 0 ? count : 1;
+
+}
+
+void simulateShotsBatch( const GameWorld *gw, const ShotParams *shots, int n, ShotOutcome *outcomes ) {
+
+    pthread_once( &defaultSimulatorOnce, setupDefaultBatchSimulator );
+
+    // the simulator plays one batch at a time
+    pthread_mutex_lock( &defaultSimulatorLock );
+    simulateShotsBatchWith( &defaultSimulator, gw, shots, n, outcomes );
+    pthread_mutex_unlock( &defaultSimulatorLock );
+
+}
+
+void simulateShotsBatchWithThreads( const GameWorld *gw, const ShotParams *shots, int n, ShotOutcome *outcomes, int threadCount ) {
+
+    BatchSimulator bs;
+
+    setupBatchSimulator( &bs, threadCount < n ? threadCount : n );
+    simulateShotsBatchWith( &bs, gw, shots, n, outcomes );
+    destroyBatchSimulator( &bs );
+
+}
+
+void setupBatchSimulator( BatchSimulator *bs, int threadCount ) {
+
+    bs->pool = NULL;
+    bs->world = (GameWorld*) malloc( sizeof( GameWorld ) );
+    bs->threadCount = 1;
+
+    if ( threadCount > BATCH_SIMULATION_MAX_THREADS ) {
+        threadCount = BATCH_SIMULATION_MAX_THREADS;
+    }
+
+    if ( threadCount < 2 ) {
+        return;
+    }
+
+    BatchWorkerPool *pool = (BatchWorkerPool*) calloc( 1, sizeof( BatchWorkerPool ) );
+
+    if ( pool == NULL ) {
+        return;
+    }
+
+    pthread_mutex_init( &pool->lock, NULL );
+    pthread_cond_init( &pool->wake, NULL );
+    pthread_cond_init( &pool->idle, NULL );
+
+    // the calling thread is a worker too
+    for ( int i = 1; i < threadCount; i++ ) {
+
+        BatchWorker *worker = &pool->workers[pool->workerCount];
+        worker->pool = pool;
+        worker->world = (GameWorld*) malloc( sizeof( GameWorld ) );
+
+        if ( worker->world == NULL ) {
+            break;
+        }
+
+        if ( pthread_create( &worker->thread, NULL, batchWorker, worker ) != 0 ) {
+            free( worker->world );
+            break;
+        }
+
+        pool->workerCount++;
+
+    }
+
+    bs->pool = pool;
+    bs->threadCount += pool->workerCount;
+
+}
+
+void destroyBatchSimulator( BatchSimulator *bs ) {
+
+    BatchWorkerPool *pool = bs->pool;
+
+    if ( pool != NULL ) {
+
+        pthread_mutex_lock( &pool->lock );
+        pool->quit = true;
+        pthread_cond_broadcast( &pool->wake );
+        pthread_mutex_unlock( &pool->lock );
+
+        for ( int i = 0; i < pool->workerCount; i++ ) {
+            pthread_join( pool->workers[i].thread, NULL );
+            free( pool->workers[i].world );
+        }
+
+        pthread_cond_destroy( &pool->idle );
+        pthread_cond_destroy( &pool->wake );
+        pthread_mutex_destroy( &pool->lock );
+        free( pool );
+
+    }
+
+    free( bs->world );
+    bs->pool = NULL;
+    bs->world = NULL;
+    bs->threadCount = 0;
+
+}
+
+void simulateShotsBatchWith( BatchSimulator *bs, const GameWorld *gw, const ShotParams *shots, int n, ShotOutcome *outcomes ) {
+
+    // workers are only started with a world, so only a simulator without
+    // any world can leave shots unplayed
+    if ( bs->world == NULL && ( bs->pool == NULL || bs->pool->workerCount == 0 ) ) {
+        for ( int i = 0; i < n; i++ ) {
+            outcomes[i].simulated = false;
+        }
+        return;
+    }
+
+    BatchJob job = {
+        .source = gw,
+        .shots = shots,
+        .outcomes = outcomes,
+        .count = n,
+        .next = 0
+    };
+
+    BatchWorkerPool *pool = bs->pool;
+
+    if ( pool != NULL ) {
+        pthread_mutex_lock( &pool->lock );
+        pool->job = &job;
+        pool->batch++;
+        pthread_cond_broadcast( &pool->wake );
+        pthread_mutex_unlock( &pool->lock );
+    }
+
+    if ( bs->world != NULL ) {
+        runBatchJob( &job, bs->world );
+    }
+
+    // once every shot is taken, workers that didn't wake up yet skip the
+    // batch and the others finish it
+    if ( pool != NULL ) {
+        pthread_mutex_lock( &pool->lock );
+        while ( pool->active > 0 || __atomic_load_n( &job.next, __ATOMIC_RELAXED ) < n ) {
+            pthread_cond_wait( &pool->idle, &pool->lock );
+        }
+        pool->job = NULL;
+        pthread_mutex_unlock( &pool->lock );
+    }
+
+}
+
+void simulateShotOutcome( GameWorld *gw, const ShotParams *shot, ShotOutcome *outcome ) {
+
+    CueStick *shooter = gw->currentCueStick;
+    int lead = scoreLead( gw, shooter );
+
+    strikeShot( gw, shot );
+
+    int steps = 0;
+    SimulationStepReport report;
+
+    do {
+        report = simulateNextStep( gw );
+        steps++;
+        // the slow tail of a shot is jumped over
+        if ( report.ballsMoving && steps % QUIET_CHECK_INTERVAL == 0 && settleQuietBalls( gw ) ) {
+            report.ballsMoving = false;
+        }
+    } while ( report.ballsMoving && steps < SIMULATION_MAX_SHOT_STEPS );
+
+    judgeShot( gw, shooter, lead, steps, outcome );
+
+}
+
+void screenShotOutcome( GameWorld *gw, const ShotParams *shot, ShotOutcome *outcome ) {
+
+    CueStick *shooter = gw->currentCueStick;
+    int lead = scoreLead( gw, shooter );
+
+    strikeShot( gw, shot );
+    int events = resolveShotEvents( gw );
+
+    judgeShot( gw, shooter, lead, events, outcome );
+
+}
+
+static void setupDefaultBatchSimulator( void ) {
+    setupBatchSimulator( &defaultSimulator, getProcessorCount() );
+}
+
+static void *batchWorker( void *data ) {
+
+    BatchWorker *worker = (BatchWorker*) data;
+    BatchWorkerPool *pool = worker->pool;
+    int batch = 0;
+
+    pthread_mutex_lock( &pool->lock );
+
+    for ( ;; ) {
+
+        while ( !pool->quit && ( pool->job == NULL || pool->batch == batch ) ) {
+            pthread_cond_wait( &pool->wake, &pool->lock );
+        }
+
+        if ( pool->quit ) {
+            break;
+        }
+
+        BatchJob *job = pool->job;
+        batch = pool->batch;
+        pool->active++;
+
+        pthread_mutex_unlock( &pool->lock );
+        runBatchJob( job, worker->world );
+        pthread_mutex_lock( &pool->lock );
+
+        if ( --pool->active == 0 ) {
+            pthread_cond_signal( &pool->idle );
+        }
+
+    }
+
+    pthread_mutex_unlock( &pool->lock );
+
+    return NULL;
+
+}
+
+static void runBatchJob( BatchJob *job, GameWorld *gw ) {
+
+    for ( ;; ) {
+
+        int i = __atomic_fetch_add( &job->next, 1, __ATOMIC_RELAXED );
+
+        if ( i >= job->count ) {
+            break;
+        }
+
+        cloneGameWorld( gw, job->source );
+        simulateShotOutcome( gw, &job->shots[i], &job->outcomes[i] );
+
+    }
+
+}
+
+static void strikeShot( GameWorld *gw, const ShotParams *shot ) {
+
+    CueStick *shooter = gw->currentCueStick;
+
+    shooter->angle = shot->angle;
+    shooter->power = shot->power;
+    shooter->hitPoint = shot->hitPoint;
+
+    strikeCueBall( gw );
+
+}
+
+// points of the player ahead of the other one
+static int scoreLead( const GameWorld *gw, const CueStick *cs ) {
+    const CueStick *other = cs == &gw->cueStickP1 ? &gw->cueStickP2 : &gw->cueStickP1;
+    return cs->score - other->score;
+}
+
+static void judgeShot( GameWorld *gw, CueStick *shooter, int lead, int steps, ShotOutcome *outcome ) {
+
+    // the table as the balls stopped, the rules may rack them again
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        outcome->positions[i] = (Vector2) { gw->physics.x[i], gw->physics.y[i] };
+        outcome->pocketed[i] = gw->physics.pocketed[i];
+    }
+
+    outcome->simulated = true;
+    outcome->statistics = gw->statistics;
+    outcome->steps = steps;
+
+    finishShot( gw );
+
+    outcome->state = gw->state;
+    outcome->keepsTurn = gw->currentCueStick == shooter;
+    outcome->gameOver = getGameRules( gw->rulesType )->isGameOver( gw );
+    outcome->wins = outcome->gameOver && gw->winnerCueStick == shooter;
+    outcome->points = scoreLead( gw, shooter ) - lead;
+    outcome->checksum = gw->checksum;
+
+}
@@ -0,0 +1,112 @@
+/**
+ * @file BinaryIO.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Little endian binary file helpers implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "BinaryIO.h"
+
+static void writeBytes( FILE *file, uint64_t value, int size );
+static bool readBytes( FILE *file, uint64_t *value, int size );
+
+void writeUint8( FILE *file, uint8_t value ) {
+    writeBytes( file, value, 1 );
+}
+
+void writeUint16( FILE *file, uint16_t value ) {
+    writeBytes( file, value, 2 );
+}
+
+void writeUint32( FILE *file, uint32_t value ) {
+    writeBytes( file, value, 4 );
+}
+
+void writeUint64( FILE *file, uint64_t value ) {
+    writeBytes( file, value, 8 );
+}
+
+void writeInt32( FILE *file, int32_t value ) {
+    writeBytes( file, (uint32_t) value, 4 );
+}
+
+void writeFloat( FILE *file, float value ) {
+    uint32_t bits;
+    memcpy( &bits, &value, sizeof( bits ) );
+    writeBytes( file, bits, 4 );
+}
+
+bool readUint8( FILE *file, uint8_t *value ) {
+    uint64_t v;
+    bool ok = readBytes( file, &v, 1 );
+    *value = (uint8_t) v;
+    return ok;
+}
+
+bool readUint16( FILE *file, uint16_t *value ) {
+    uint64_t v;
+    bool ok = readBytes( file, &v, 2 );
+    *value = (uint16_t) v;
+    return ok;
+}
+
+bool readUint32( FILE *file, uint32_t *value ) {
+    uint64_t v;
+    bool ok = readBytes( file, &v, 4 );
+    *value = (uint32_t) v;
+    return ok;
+}
+
+bool readUint64( FILE *file, uint64_t *value ) {
+    return readBytes( file, value, 8 );
+}
+
+bool readInt32( FILE *file, int32_t *value ) {
+    uint64_t v;
+    bool ok = readBytes( file, &v, 4 );
+    *value = (int32_t) (uint32_t) v;
+    return ok;
+}
+
+bool readFloat( FILE *file, float *value ) {
+    uint64_t v;
+    bool ok = readBytes( file, &v, 4 );
+    uint32_t bits = (uint32_t) v;
+    memcpy( value, &bits, sizeof( bits ) );
+    return ok;
+}
+
+static void writeBytes( FILE *file, uint64_t value, int size ) {
+
+    unsigned char bytes[8];
+
+    for ( int i = 0; i < size; i++ ) {
+        bytes[i] = (unsigned char) ( value >> ( i * 8 ) );
+    }
+
+    fwrite( bytes, 1, size, file );
+
+}
+
+static bool readBytes( FILE *file, uint64_t *value, int size ) {
+
+    unsigned char bytes[8];
+    *value = 0;
+
+    if ( fread( bytes, 1, size, file ) != (size_t) size ) {
+        return false;
+    }
+
+    for ( int i = 0; i < size; i++ ) {
+        *value |= (uint64_t) bytes[i] << ( i * 8 );
+    }
+
+    return true;
+
+}
@@ -0,0 +1,191 @@
+/**
+ * @file Broadphase.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Ball x ball broadphase implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+
+#include "Broadphase.h"
+#include "CommonMacros.h"
+#include "Types.h"
+
+static float leftOf( const BallBatch *bb, int i );
+static float rightOf( const BallBatch *bb, int i );
+static float topOf( const BallBatch *bb, int i );
+static float bottomOf( const BallBatch *bb, int i );
+static int findIsland( int *parents, int i );
+
+void setupBroadphase( Broadphase *bp ) {
+
+    for ( int i = 0; i < BALL_CAPACITY; i++ ) {
+        bp->order[i] = i;
+    }
+
+    bp->pairCount = 0;
+    bp->islandCount = 0;
+
+    for ( int i = 0; i < BALL_CAPACITY; i++ ) {
+        bp->islands[i] = -1;
+    }
+
+}
+
+void updateBroadphase( Broadphase *bp, const BallBatch *bb, int count ) {
+
+    // insertion sort: the order of the last update is almost sorted already
+    for ( int i = 1; i < count; i++ ) {
+        int current = bp->order[i];
+        float left = leftOf( bb, current );
+        int j = i - 1;
+        while ( j >= 0 && leftOf( bb, bp->order[j] ) > left ) {
+            bp->order[j+1] = bp->order[j];
+            j--;
+        }
+        bp->order[j+1] = current;
+    }
+
+    bp->pairCount = 0;
+
+    for ( int i = 0; i < count; i++ ) {
+
+        int a = bp->order[i];
+
+        if ( bb->pocketed[a] ) {
+            continue;
+        }
+
+        float right = rightOf( bb, a );
+
+        for ( int j = i + 1; j < count; j++ ) {
+
+            int b = bp->order[j];
+
+            // every next ball starts after this one ends
+            if ( leftOf( bb, b ) > right ) {
+                break;
+            }
+
+            if ( bb->pocketed[b] ) {
+                continue;
+            }
+
+            if ( topOf( bb, a ) > bottomOf( bb, b ) || topOf( bb, b ) > bottomOf( bb, a ) ) {
+                continue;
+            }
+
+            bp->pairs[bp->pairCount++] = (BallPair) {
+                .a = a < b ? a : b,
+                .b = a < b ? b : a
+            };
+
+        }
+
+    }
+
+}
+
+void buildBroadphaseIslands( Broadphase *bp, bool *awake, int count ) {
+
+    int parents[BALL_CAPACITY];
+
+    for ( int i = 0; i < count; i++ ) {
+        parents[i] = i;
+    }
+
+    // union find over the pairs that can change this step
+    int kept = 0;
+
+    for ( int i = 0; i < bp->pairCount; i++ ) {
+        BallPair p = bp->pairs[i];
+        if ( awake[p.a] || awake[p.b] ) {
+            parents[findIsland( parents, p.a )] = findIsland( parents, p.b );
+            bp->pairs[kept++] = p;
+        }
+    }
+
+    bp->pairCount = kept;
+    bp->islandCount = 0;
+
+    // island numbers follow the order of the first pair of each island
+    int rootIslands[BALL_CAPACITY];
+
+    for ( int i = 0; i < count; i++ ) {
+        rootIslands[i] = -1;
+        bp->islands[i] = -1;
+    }
+
+    for ( int i = 0; i < kept; i++ ) {
+        int root = findIsland( parents, bp->pairs[i].a );
+        if ( rootIslands[root] == -1 ) {
+            rootIslands[root] = bp->islandCount++;
+        }
+        bp->islands[bp->pairs[i].a] = rootIslands[root];
+        bp->islands[bp->pairs[i].b] = rootIslands[root];
+    }
+
+}
+
+void joinBroadphaseIslands( Broadphase *bp, int count, int a, int b ) {
+
+    BallPair pair = {
+        .a = a < b ? a : b,
+        .b = a < b ? b : a
+    };
+
+    for ( int i = 0; i < bp->pairCount; i++ ) {
+        if ( bp->pairs[i].a == pair.a && bp->pairs[i].b == pair.b ) {
+            return;
+        }
+    }
+
+    bp->pairs[bp->pairCount++] = pair;
+
+    int from = bp->islands[b];
+    int to = bp->islands[a];
+
+    if ( from == -1 ) {
+        bp->islands[b] = to;
+    } else if ( from != to ) {
+        for ( int i = 0; i < count; i++ ) {
+            if ( bp->islands[i] == from ) {
+                bp->islands[i] = to;
+            }
+        }
+    }
+
+}
+
+bool sweptBoundsOverlap( const BallBatch *bb, int a, int b ) {
+    return leftOf( bb, b ) <= rightOf( bb, a ) && leftOf( bb, a ) <= rightOf( bb, b ) &&
+           topOf( bb, b ) <= bottomOf( bb, a ) && topOf( bb, a ) <= bottomOf( bb, b );
+}
+
+static float leftOf( const BallBatch *bb, int i ) {
+    return fminf( bb->px[i], bb->x[i] ) - bb->radius[i];
+}
+
+static float rightOf( const BallBatch *bb, int i ) {
+    return fmaxf( bb->px[i], bb->x[i] ) + bb->radius[i];
+}
+
+static float topOf( const BallBatch *bb, int i ) {
+    return fminf( bb->py[i], bb->y[i] ) - bb->radius[i];
+}
+
+static float bottomOf( const BallBatch *bb, int i ) {
+    return fmaxf( bb->py[i], bb->y[i] ) + bb->radius[i];
+}
+
+static int findIsland( int *parents, int i ) {
+    while ( parents[i] != i ) {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
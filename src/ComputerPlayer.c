@@ -0,0 +1,445 @@
+/**
+ * @file ComputerPlayer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Computer opponent implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+// clock_gettime
+#define _POSIX_C_SOURCE 199309L
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <pthread.h>
+
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+
+#include "BallMask.h"
+#include "BatchSimulation.h"
+#include "CommonMacros.h"
+#include "ComputerPlayer.h"
+#include "Determinism.h"
+#include "GameRules.h"
+#include "Simulation.h"
+#include "Types.h"
+
+// candidates evaluated together, per processor (threaded search) or per poll
+#define SHOTS_PER_PROCESSOR 2
+#define SHOTS_PER_POLL 2
+#define MAX_BATCH_SHOTS 128
+
+// aimed candidates: every ball but the cue ball x pocket x power
+#define MAX_AIMED_SHOTS ( ( BALL_CAPACITY - 1 ) * 6 * 3 )
+
+// random shots screened by the event driven simulation for each one played
+#define SCREENED_RANDOM_SHOTS 4
+
+typedef struct ComputerPlayerSearch {
+
+    GameWorld world;            // the table when the search started
+    BatchSimulator *simulator;
+    float timeBudget;
+    double startTime;
+
+    bool threaded;
+    pthread_t thread;
+    int done;                   // atomic, set when best holds the result
+    int cancelled;              // atomic
+
+    RandomGenerator rng;
+    ShotParams aimed[MAX_AIMED_SHOTS];
+    int aimedCount;
+    int nextAimed;
+
+    ShotParams best;
+    float bestScore;
+    bool hasBest;
+
+    GameWorld screenWorld;      // where the random shots are screened
+
+} ComputerPlayerSearch;
+
+static const float timeBudgets[] = { 0.25f, 1.0f, 3.0f };
+static const char *difficultyNames[] = { "Easy", "Medium", "Hard" };
+
+static void *searchThread( void *data );
+static bool searchBatch( ComputerPlayerSearch *search, int size );
+static void generateAimedShots( ComputerPlayerSearch *search );
+static ShotParams generateShot( ComputerPlayerSearch *search );
+static ShotParams screenRandomShots( ComputerPlayerSearch *search );
+static float screenShot( ComputerPlayerSearch *search, const ShotParams *shot );
+static float scoreOutcome( const GameWorld *gw, const ShotOutcome *outcome );
+static BallMask ownBalls( BallGroup group );
+static float randomUnit( RandomGenerator *rng );
+static double elapsedTime( ComputerPlayerSearch *search );
+static double monotonicTime( void );
+
+void setupComputerPlayer( ComputerPlayer *cp, ComputerPlayerDifficulty difficulty ) {
+    cp->enabled = false;
+    cp->search = NULL;
+    setupBatchSimulator( &cp->simulator, getProcessorCount() );
+    setComputerPlayerDifficulty( cp, difficulty );
+}
+
+void destroyComputerPlayer( ComputerPlayer *cp ) {
+    cancelComputerPlayerSearch( cp );
+    destroyBatchSimulator( &cp->simulator );
+}
+
+void setComputerPlayerDifficulty( ComputerPlayer *cp, ComputerPlayerDifficulty difficulty ) {
+    cp->difficulty = difficulty;
+    cp->timeBudget = timeBudgets[difficulty];
+}
+
+const char *getComputerPlayerDifficultyName( ComputerPlayerDifficulty difficulty ) {
+    return difficultyNames[difficulty];
+}
+
+void startComputerPlayerSearch( ComputerPlayer *cp, const GameWorld *gw ) {
+
+    cancelComputerPlayerSearch( cp );
+
+    ComputerPlayerSearch *search = (ComputerPlayerSearch*) malloc( sizeof( ComputerPlayerSearch ) );
+
+    if ( search == NULL ) {
+        return;
+    }
+
+    cloneGameWorld( &search->world, gw );
+    search->simulator = &cp->simulator;
+    search->timeBudget = cp->timeBudget;
+    search->startTime = monotonicTime();
+    search->done = 0;
+    search->cancelled = 0;
+    search->hasBest = false;
+    search->bestScore = 0.0f;
+
+    // the search doesn't advance the random numbers of the game
+    search->rng = gw->rng;
+    nextRandomValue( &search->rng, 0, 1 );
+
+    generateAimedShots( search );
+
+    search->threaded = pthread_create( &search->thread, NULL, searchThread, search ) == 0;
+    cp->search = search;
+
+}
+
+bool pollComputerPlayerSearch( ComputerPlayer *cp, ShotParams *shot ) {
+
+    ComputerPlayerSearch *search = cp->search;
+
+    if ( search == NULL ) {
+        return false;
+    }
+
+    if ( search->threaded ) {
+        if ( !__atomic_load_n( &search->done, __ATOMIC_ACQUIRE ) ) {
+            return false;
+        }
+        pthread_join( search->thread, NULL );
+    } else if ( searchBatch( search, SHOTS_PER_POLL ) ) {
+        return false;
+    }
+
+    *shot = search->best;
+
+    free( search );
+    cp->search = NULL;
+
+    return true;
+
+}
+
+void cancelComputerPlayerSearch( ComputerPlayer *cp ) {
+
+    ComputerPlayerSearch *search = cp->search;
+
+    if ( search == NULL ) {
+        return;
+    }
+
+    // the thread notices between two batches
+    if ( search->threaded ) {
+        __atomic_store_n( &search->cancelled, 1, __ATOMIC_RELAXED );
+        pthread_join( search->thread, NULL );
+    }
+
+    free( search );
+    cp->search = NULL;
+
+}
+
+static void *searchThread( void *data ) {
+
+    ComputerPlayerSearch *search = (ComputerPlayerSearch*) data;
+
+    int size = search->simulator->threadCount * SHOTS_PER_PROCESSOR;
+
+    if ( size > MAX_BATCH_SHOTS ) {
+        size = MAX_BATCH_SHOTS;
+    }
+
+    while ( !__atomic_load_n( &search->cancelled, __ATOMIC_RELAXED ) && searchBatch( search, size ) ) {
+    }
+
+    __atomic_store_n( &search->done, 1, __ATOMIC_RELEASE );
+
+    return NULL;
+
+}
+
+/**
+ * Evaluates size more candidates. Returns false when the search is over:
+ * the time budget ran out after at least one batch.
+ */
+static bool searchBatch( ComputerPlayerSearch *search, int size ) {
+
+    if ( search->hasBest && elapsedTime( search ) >= search->timeBudget ) {
+        return false;
+    }
+
+    ShotParams shots[MAX_BATCH_SHOTS];
+    ShotOutcome outcomes[MAX_BATCH_SHOTS];
+
+    for ( int i = 0; i < size; i++ ) {
+        shots[i] = generateShot( search );
+    }
+
+    simulateShotsBatchWith( search->simulator, &search->world, shots, size, outcomes );
+
+    int scored = 0;
+
+    for ( int i = 0; i < size; i++ ) {
+        if ( !outcomes[i].simulated ) {
+            continue;
+        }
+        float score = scoreOutcome( &search->world, &outcomes[i] );
+        if ( !search->hasBest || score > search->bestScore ) {
+            search->best = shots[i];
+            search->bestScore = score;
+            search->hasBest = true;
+        }
+        scored++;
+    }
+
+    // without memory to simulate, the first candidate is played blind
+    if ( scored == 0 ) {
+        if ( !search->hasBest ) {
+            search->best = shots[0];
+            search->hasBest = true;
+        }
+        return false;
+    }
+
+    return elapsedTime( search ) < search->timeBudget;
+
+}
+
+/**
+ * Ghost ball aiming: for each ball the rules let the cue ball hit first and
+ * each pocket, the cue ball is sent to the point where it touches the ball
+ * along the ball to pocket line. The
+ * straightest cuts come first, as they are the likeliest to score.
+ */
+static void generateAimedShots( ComputerPlayerSearch *search ) {
+
+    GameWorld *gw = &search->world;
+    Ball *cueBall = gw->cueBall;
+    BallMask targets = getGameRules( gw->rulesType )->legalTargets( gw );
+    int maxPower = gw->currentCueStick->maxPower;
+    float powers[] = { 0.45f, 0.7f, 0.3f };
+    float cuts[MAX_AIMED_SHOTS];
+
+    // the break must spread the rack
+    if ( gw->state == GAME_STATE_BREAKING ) {
+        powers[0] = 1.0f;
+        powers[1] = 0.9f;
+        powers[2] = 0.8f;
+    }
+
+    search->aimedCount = 0;
+    search->nextAimed = 0;
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+
+        Ball *b = &gw->balls[i];
+
+        if ( b == cueBall || b->pocketed || !( targets & BALL_MASK( b->number ) ) ) {
+            continue;
+        }
+
+        for ( int j = 0; j < 6; j++ ) {
+
+            Vector2 toPocket = Vector2Normalize( Vector2Subtract( gw->pockets[j].center, b->center ) );
+            Vector2 ghost = Vector2Subtract( b->center, Vector2Scale( toPocket, b->radius + cueBall->radius ) );
+            Vector2 toGhost = Vector2Normalize( Vector2Subtract( ghost, cueBall->center ) );
+
+            // 1 is a straight shot, cuts over 80 degrees don't work
+            float cut = Vector2DotProduct( toGhost, toPocket );
+
+            if ( cut < 0.17f ) {
+                continue;
+            }
+
+            float angle = RAD2DEG * atan2f( toGhost.y, toGhost.x );
+
+            for ( int k = 0; k < 3 && search->aimedCount < MAX_AIMED_SHOTS; k++ ) {
+
+                // insertion by power, then by cut, straightest first
+                float key = cut - k;
+                int p = search->aimedCount++;
+                while ( p > 0 && cuts[p-1] < key ) {
+                    cuts[p] = cuts[p-1];
+                    search->aimed[p] = search->aimed[p-1];
+                    p--;
+                }
+
+                cuts[p] = key;
+                search->aimed[p] = (ShotParams) {
+                    .angle = angle,
+                    .power = (int) ( maxPower * powers[k] ),
+                    .hitPoint = { 0.0f, 0.0f }
+                };
+
+            }
+
+        }
+
+    }
+
+}
+
+/**
+ * The aimed shots first, then variations of the best shot so far mixed
+ * with screened random shots.
+ */
+static ShotParams generateShot( ComputerPlayerSearch *search ) {
+
+    if ( search->nextAimed < search->aimedCount ) {
+        return search->aimed[search->nextAimed++];
+    }
+
+    int maxPower = search->world.currentCueStick->maxPower;
+    RandomGenerator *rng = &search->rng;
+
+    if ( search->hasBest && nextRandomValue( rng, 0, 3 ) != 0 ) {
+        ShotParams shot = search->best;
+        shot.angle += randomUnit( rng ) * 3.0f;
+        shot.power = (int) Clamp( shot.power * ( 1.0f + randomUnit( rng ) * 0.25f ), maxPower * 0.1f, maxPower );
+        shot.hitPoint.x = Clamp( shot.hitPoint.x + randomUnit( rng ) * 0.3f, -1.0f, 1.0f );
+        shot.hitPoint.y = Clamp( shot.hitPoint.y + randomUnit( rng ) * 0.3f, -1.0f, 1.0f );
+        return shot;
+    }
+
+    return screenRandomShots( search );
+
+}
+
+/**
+ * Most random shots are worthless. A few of them are played by the event
+ * driven simulation, many times cheaper than the stepper, and the best one
+ * is the candidate.
+ */
+static ShotParams screenRandomShots( ComputerPlayerSearch *search ) {
+
+    int maxPower = search->world.currentCueStick->maxPower;
+    RandomGenerator *rng = &search->rng;
+    ShotParams best = { 0 };
+    float bestScore = 0.0f;
+
+    for ( int i = 0; i < SCREENED_RANDOM_SHOTS; i++ ) {
+
+        ShotParams shot = {
+            .angle = nextRandomValue( rng, 0, 35999 ) / 100.0f,
+            .power = nextRandomValue( rng, maxPower / 10, maxPower ),
+            .hitPoint = { randomUnit( rng ) * 0.5f, randomUnit( rng ) * 0.5f }
+        };
+
+        float score = screenShot( search, &shot );
+
+        if ( i == 0 || score > bestScore ) {
+            best = shot;
+            bestScore = score;
+        }
+
+    }
+
+    return best;
+
+}
+
+static float screenShot( ComputerPlayerSearch *search, const ShotParams *shot ) {
+
+    ShotOutcome outcome;
+
+    cloneGameWorld( &search->screenWorld, &search->world );
+    screenShotOutcome( &search->screenWorld, shot, &outcome );
+
+    return scoreOutcome( &search->world, &outcome );
+
+}
+
+/**
+ * Winning is all that matters, then keeping the turn, then pocketing more
+ * balls of the own group. Fouls give the opponent ball in hand and an
+ * invalid break racks the balls again, so both are avoided. In the games
+ * that count points, each point won or given away weighs too.
+ */
+static float scoreOutcome( const GameWorld *gw, const ShotOutcome *outcome ) {
+
+    if ( outcome->gameOver ) {
+        return outcome->wins ? 10000.0f : -10000.0f;
+    }
+
+    float score = 0.0f;
+    BallGroup group = gw->currentCueStick->group;
+
+    if ( outcome->keepsTurn ) {
+        score += 100.0f;
+    }
+
+    if ( outcome->statistics.cueBallPocketed || outcome->state == GAME_STATE_BALL_IN_HAND ) {
+        score -= 200.0f;
+    }
+
+    if ( gw->state == GAME_STATE_BREAKING ) {
+        if ( outcome->state == GAME_STATE_BREAKING ) {
+            score -= 200.0f;
+        }
+        score += 10.0f * countBallMask( outcome->statistics.touchedCushion );
+    }
+
+    int own = countBallMask( outcome->statistics.pocketed & ownBalls( group ) );
+    int others = countBallMask( outcome->statistics.pocketed ) - own;
+    score += 30.0f * own - 20.0f * others;
+    score += 20.0f * outcome->points;
+
+    return score;
+
+}
+
+// any ball without a group, pocketing the 8 then ends the game anyway
+static BallMask ownBalls( BallGroup group ) {
+    return group == BALL_GROUP_UNDEFINED ? (BallMask) ~CUE_BALL_MASK : groupBallMask( group );
+}
+
+// uniform in [-1, 1]
+static float randomUnit( RandomGenerator *rng ) {
+    return nextRandomValue( rng, -10000, 10000 ) / 10000.0f;
+}
+
+static double elapsedTime( ComputerPlayerSearch *search ) {
+    return monotonicTime() - search->startTime;
+}
+
+static double monotonicTime( void ) {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
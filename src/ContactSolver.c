@@ -0,0 +1,250 @@
+/**
+ * @file ContactSolver.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Simultaneous ball x ball contact solver implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+
+#include "CommonMacros.h"
+#include "ContactSolver.h"
+#include "Types.h"
+
+// gap still taken as a contact: the balls of the rack are less than 0.5 pixels apart
+#define CONTACT_MARGIN 1.0f
+
+// equal masses: each ball takes half of the velocity change
+#define CONTACT_EFFECTIVE_MASS 0.5f
+
+// ball x ball collisions keep all the energy
+#define CONTACT_RESTITUTION 1.0f
+
+#define MAX_WAVES 16
+#define MAX_ITERATIONS 32
+#define CONVERGENCE_TOLERANCE 0.001f // pixels/second
+
+static bool touching( const BallBatch *bb, int a, int b );
+static int pairIndex( int a, int b );
+static void addImpulse( ContactSolver *cs, int pair, float impulse );
+static float normalSpeed( const BallBatch *bb, BallContact *c );
+static void applyImpulse( BallBatch *bb, BallContact *c, float impulse );
+
+void setupContactSolver( ContactSolver *cs ) {
+
+    for ( int i = 0; i < CONTACT_SOLVER_MAX_CONTACTS; i++ ) {
+        cs->impulses[i] = 0.0f;
+        cs->warmImpulses[i] = 0.0f;
+    }
+
+    cs->solvedCount = 0;
+    cs->warmCount = 0;
+    cs->iterations = 0;
+
+}
+
+void beginContactSolverStep( ContactSolver *cs ) {
+
+    for ( int i = 0; i < cs->warmCount; i++ ) {
+        cs->warmImpulses[cs->warmPairs[i]] = 0.0f;
+    }
+
+    for ( int i = 0; i < cs->solvedCount; i++ ) {
+        int pair = cs->solvedPairs[i];
+        cs->warmImpulses[pair] = cs->impulses[pair];
+        cs->impulses[pair] = 0.0f;
+        cs->warmPairs[i] = pair;
+    }
+
+    cs->warmCount = cs->solvedCount;
+    cs->solvedCount = 0;
+
+}
+
+int solveBallContacts( ContactSolver *cs, BallBatch *bb, const int *candidates, int candidateCount, int a, int b, BallContact *contacts ) {
+
+    // the group: every ball reached from the pair through touching balls
+    bool grouped[BALL_CAPACITY] = { false };
+    int group[BALL_CAPACITY];
+    int groupCount = 0;
+
+    group[groupCount++] = a;
+    group[groupCount++] = b;
+    grouped[a] = grouped[b] = true;
+
+    for ( int i = 0; i < groupCount; i++ ) {
+        for ( int k = 0; k < candidateCount; k++ ) {
+            int j = candidates[k];
+            if ( !grouped[j] && !bb->pocketed[j] && touching( bb, group[i], j ) ) {
+                group[groupCount++] = j;
+                grouped[j] = true;
+            }
+        }
+    }
+
+    // the contacts come in pair order, so only the group is sorted and
+    // searched, not every ball of the table
+    int sorted[BALL_CAPACITY];
+
+    for ( int i = 0; i < groupCount; i++ ) {
+        int p = i;
+        while ( p > 0 && sorted[p-1] > group[i] ) {
+            sorted[p] = sorted[p-1];
+            p--;
+        }
+        sorted[p] = group[i];
+    }
+
+    int contactCount = 0;
+
+    for ( int i = 0; i < groupCount; i++ ) {
+        for ( int j = i + 1; j < groupCount; j++ ) {
+            int a = sorted[i];
+            int b = sorted[j];
+            if ( touching( bb, a, b ) ) {
+                contacts[contactCount++] = (BallContact) {
+                    .a = a,
+                    .b = b,
+                    .normal = Vector2Normalize( (Vector2) { bb->x[b] - bb->x[a], bb->y[b] - bb->y[a] } )
+                };
+            }
+        }
+    }
+
+    // a wave solves together the contacts approaching when it starts, so
+    // a hit runs through a line of balls one contact after the other
+    bool active[CONTACT_SOLVER_MAX_CONTACTS];
+    float waveImpulses[CONTACT_SOLVER_MAX_CONTACTS];
+    cs->iterations = 0;
+
+    for ( int wave = 0; wave < MAX_WAVES; wave++ ) {
+
+        int activeCount = 0;
+
+        for ( int i = 0; i < contactCount; i++ ) {
+
+            BallContact *c = &contacts[i];
+            float speed = normalSpeed( bb, c );
+            active[i] = speed < 0.0f;
+
+            if ( active[i] ) {
+                int pair = pairIndex( c->a, c->b );
+                c->target = -CONTACT_RESTITUTION * speed;
+                waveImpulses[i] = cs->warmImpulses[pair];
+                cs->warmImpulses[pair] = 0.0f;
+                applyImpulse( bb, c, waveImpulses[i] );
+                activeCount++;
+            }
+
+        }
+
+        if ( activeCount == 0 ) {
+            break;
+        }
+
+        // projected Gauss-Seidel: iterated until the impulses settle, so the
+        // order of the contacts doesn't matter
+        for ( int n = 0; n < MAX_ITERATIONS; n++ ) {
+
+            float largestChange = 0.0f;
+
+            for ( int i = 0; i < contactCount; i++ ) {
+
+                if ( !active[i] ) {
+                    continue;
+                }
+
+                BallContact *c = &contacts[i];
+                float delta = ( c->target - normalSpeed( bb, c ) ) * CONTACT_EFFECTIVE_MASS;
+                float impulse = fmaxf( waveImpulses[i] + delta, 0.0f );
+
+                applyImpulse( bb, c, impulse - waveImpulses[i] );
+                largestChange = fmaxf( largestChange, fabsf( impulse - waveImpulses[i] ) );
+                waveImpulses[i] = impulse;
+
+            }
+
+            cs->iterations++;
+
+            if ( largestChange < CONVERGENCE_TOLERANCE ) {
+                break;
+            }
+
+        }
+
+        for ( int i = 0; i < contactCount; i++ ) {
+            if ( active[i] ) {
+                contacts[i].impulse += waveImpulses[i];
+                addImpulse( cs, pairIndex( contacts[i].a, contacts[i].b ), waveImpulses[i] );
+            }
+        }
+
+    }
+
+    // overlaps are undone all at once, each ball takes half
+    Vector2 corrections[BALL_CAPACITY] = { 0 };
+
+    for ( int i = 0; i < contactCount; i++ ) {
+
+        BallContact *c = &contacts[i];
+        float distance = Vector2Distance( (Vector2) { bb->x[c->a], bb->y[c->a] }, (Vector2) { bb->x[c->b], bb->y[c->b] } );
+        float overlap = bb->radius[c->a] + bb->radius[c->b] - distance;
+
+        if ( overlap > 0.0f ) {
+            Vector2 half = Vector2Scale( c->normal, overlap / 2.0f );
+            corrections[c->a] = Vector2Subtract( corrections[c->a], half );
+            corrections[c->b] = Vector2Add( corrections[c->b], half );
+        }
+
+    }
+
+    for ( int i = 0; i < groupCount; i++ ) {
+        int k = group[i];
+        bb->x[k] += corrections[k].x;
+        bb->y[k] += corrections[k].y;
+    }
+
+    return contactCount;
+
+}
+
+static bool touching( const BallBatch *bb, int a, int b ) {
+    float dx = bb->x[b] - bb->x[a];
+    float dy = bb->y[b] - bb->y[a];
+    float r = bb->radius[a] + bb->radius[b] + CONTACT_MARGIN;
+    return dx * dx + dy * dy <= r * r;
+}
+
+// pairs a < b of BALL_CAPACITY balls, row by row
+static int pairIndex( int a, int b ) {
+    return a * ( 2 * BALL_CAPACITY - 1 - a ) / 2 + b - a - 1;
+}
+
+// impulses never go negative, so a pair is listed when its impulse of the
+// step stops being zero
+static void addImpulse( ContactSolver *cs, int pair, float impulse ) {
+
+    if ( cs->impulses[pair] == 0.0f && impulse > 0.0f ) {
+        cs->solvedPairs[cs->solvedCount++] = pair;
+    }
+
+    cs->impulses[pair] += impulse;
+
+}
+
+// positive when the balls move apart
+static float normalSpeed( const BallBatch *bb, BallContact *c ) {
+    return ( bb->vx[c->b] - bb->vx[c->a] ) * c->normal.x + ( bb->vy[c->b] - bb->vy[c->a] ) * c->normal.y;
+}
+
+static void applyImpulse( BallBatch *bb, BallContact *c, float impulse ) {
+    bb->vx[c->a] -= c->normal.x * impulse;
+    bb->vy[c->a] -= c->normal.y * impulse;
+    bb->vx[c->b] += c->normal.x * impulse;
+    bb->vy[c->b] += c->normal.y * impulse;
+}
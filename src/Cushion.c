@@ -14,8 +14,38 @@
 #include "Cushion.h"
 #include "Types.h"
 
+// bakes the edge geometry used by the collision tests
+void setupCushion( Cushion *c ) {
+
+    float minX = c->vertices[0].x;
+    float minY = c->vertices[0].y;
+    float maxX = minX;
+    float maxY = minY;
+
+    for ( int i = 0; i < 4; i++ ) {
+
+        Vector2 segDir = Vector2Subtract( c->vertices[(i+1)%4], c->vertices[i] );
+        Vector2 segNorm = Vector2Normalize( segDir );
+
+        c->edgeLengths[i] = Vector2Length( segDir );
+        c->edgeDirections[i] = segNorm;
+        c->edgeNormals[i] = (Vector2) { segNorm.y, -segNorm.x };
+
+        minX = fminf( minX, c->vertices[i].x );
+        minY = fminf( minY, c->vertices[i].y );
+        maxX = fmaxf( maxX, c->vertices[i].x );
+        maxY = fmaxf( maxY, c->vertices[i].y );
+
+    }
+
+    c->bounds = (Rectangle) { minX, minY, maxX - minX, maxY - minY };
+
+}
+
+#ifndef EBP_HEADLESS
 void drawCushion( Cushion *c ) {
     for ( int j = 0; j < 4; j++ ) {
         DrawLineV( c->vertices[j], c->vertices[(j+1)%4], BLACK );
     }
 }
+#endif
@@ -0,0 +1,290 @@
+/**
+ * @file Determinism.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Deterministic simulation support implementation.
+ *
+ * The results are only bit exact if the compiler does not contract a * b + c
+ * into a fused multiply-add, so every build script passes -ffp-contract=off.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "raylib/raylib.h"
+
+#include "CommonMacros.h"
+#include "Determinism.h"
+#include "Types.h"
+
+#define LN2 0.69314718055994530942
+#define HALF_PI 1.57079632679489661923
+#define SQRT2 1.41421356237309504880
+
+#define FNV_OFFSET_BASIS CHECKSUM_START
+#define FNV_PRIME 16777619u
+
+static double roundToInteger( double x );
+static double sinPolynomial( double r );
+static double cosPolynomial( double r );
+static uint32_t hashInt( uint32_t hash, int value );
+static uint32_t hashInts( uint32_t hash, int *values, int count );
+static uint32_t hashFloat( uint32_t hash, float value );
+static int cueStickIndex( GameWorld *gw, CueStick *cs );
+
+void seedRandom( RandomGenerator *rng, uint64_t seed ) {
+
+    // splitmix64 scrambles the seed, so close seeds give unrelated sequences
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+    z = z ^ ( z >> 31 );
+
+    rng->state = z != 0 ? z : 0x9E3779B97F4A7C15ull;
+
+}
+
+int nextRandomValue( RandomGenerator *rng, int min, int max ) {
+
+    uint64_t x = rng->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rng->state = x;
+
+    uint64_t value = x * 0x2545F4914F6CDD1Dull;
+
+    // the high bits are the best ones
+    return min + (int) ( ( value >> 32 ) % (uint64_t) ( max - min + 1 ) );
+
+}
+
+double portableExp( double x ) {
+
+    if ( x > 709.0 ) {
+        return HUGE_VAL;
+    } else if ( x < -745.0 ) {
+        return 0.0;
+    }
+
+    // x = k ln2 + r, |r| <= ln2 / 2
+    double k = roundToInteger( x / LN2 );
+    double r = x - k * LN2;
+
+    // taylor series, the last term is below 1e-17 for |r| <= 0.35
+    double term = 1.0;
+    double sum = 1.0;
+
+    for ( int i = 1; i <= 16; i++ ) {
+        term = term * r / i;
+        sum = sum + term;
+    }
+
+    // scaling by a power of two is exact
+    return ldexp( sum, (int) k );
+
+}
+
+double portableLog( double x ) {
+
+    if ( x <= 0.0 ) {
+        return -HUGE_VAL;
+    }
+
+    // x = m 2^e, sqrt(2) / 2 <= m < sqrt(2)
+    int e;
+    double m = frexp( x, &e );
+
+    if ( m < SQRT2 / 2.0 ) {
+        m = m * 2.0;
+        e--;
+    }
+
+    // log(m) = 2 atanh(s), |s| < 0.172
+    double s = ( m - 1.0 ) / ( m + 1.0 );
+    double s2 = s * s;
+    double power = s;
+    double sum = 0.0;
+
+    for ( int i = 1; i <= 27; i += 2 ) {
+        sum = sum + power / i;
+        power = power * s2;
+    }
+
+    return 2.0 * sum + e * LN2;
+
+}
+
+double portablePow( double base, double exponent ) {
+    return portableExp( exponent * portableLog( base ) );
+}
+
+double portableSin( double x ) {
+
+    // x = k pi/2 + r, |r| <= pi/4
+    double k = roundToInteger( x / HALF_PI );
+    double r = x - k * HALF_PI;
+    int quadrant = (int) fmod( k, 4.0 );
+
+    if ( quadrant < 0 ) {
+        quadrant += 4;
+    }
+
+    switch ( quadrant ) {
+        case 0: return sinPolynomial( r );
+        case 1: return cosPolynomial( r );
+        case 2: return -sinPolynomial( r );
+        default: return -cosPolynomial( r );
+    }
+
+}
+
+double portableCos( double x ) {
+    return portableSin( x + HALF_PI );
+}
+
+uint32_t checksumGameWorld( GameWorld *gw ) {
+
+    uint32_t hash = FNV_OFFSET_BASIS;
+
+    hash = hashInt( hash, gw->ballCount );
+
+    BallBatch *bb = &gw->physics;
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        hash = hashFloat( hash, bb->x[i] );
+        hash = hashFloat( hash, bb->y[i] );
+        hash = hashFloat( hash, bb->vx[i] );
+        hash = hashFloat( hash, bb->vy[i] );
+        hash = hashFloat( hash, bb->sx[i] );
+        hash = hashFloat( hash, bb->sy[i] );
+        hash = hashInt( hash, gw->balls[i].number );
+        hash = hashInt( hash, bb->pocketed[i] );
+        hash = hashInt( hash, bb->moving[i] != 0 );
+    }
+
+    CueStick *cueSticks[] = { &gw->cueStickP1, &gw->cueStickP2 };
+
+    for ( int i = 0; i < 2; i++ ) {
+        CueStick *cs = cueSticks[i];
+        hash = hashInt( hash, cs->group );
+        hash = hashInt( hash, cs->pocketed );
+        hash = hashInt( hash, cs->score );
+    }
+
+    hash = hashInt( hash, cueStickIndex( gw, gw->currentCueStick ) );
+    hash = hashInt( hash, cueStickIndex( gw, gw->lastCueStick ) );
+    hash = hashInt( hash, cueStickIndex( gw, gw->winnerCueStick ) );
+    hash = hashInt( hash, gw->rulesType );
+    hash = hashInt( hash, gw->ballsOn );
+    hash = hashInt( hash, gw->state );
+    hash = hashInt( hash, gw->ballsState );
+    hash = hashInt( hash, gw->pocketedCount );
+    hash = hashInts( hash, gw->pocketedBalls, gw->pocketedCount );
+
+    TurnStatistics *s = &gw->statistics;
+    hash = hashInt( hash, s->cueBallHits );
+    hash = hashInt( hash, s->cueBallFirstHitNumber );
+    hash = hashInt( hash, s->cueBallPocketed );
+    hash = hashInt( hash, s->touchedCushion );
+    hash = hashInt( hash, s->pocketed );
+
+    hash = hashInt( hash, (int) ( gw->rng.state & 0xFFFFFFFFu ) );
+    hash = hashInt( hash, (int) ( gw->rng.state >> 32 ) );
+
+    return hash;
+
+}
+
+uint32_t checksumBytes( uint32_t hash, const void *data, size_t size ) {
+
+    const uint8_t *bytes = (const uint8_t*) data;
+
+    for ( size_t i = 0; i < size; i++ ) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+
+}
+
+// halfway cases go up, as floor is exact on every platform
+static double roundToInteger( double x ) {
+    return floor( x + 0.5 );
+}
+
+static double sinPolynomial( double r ) {
+
+    double r2 = r * r;
+    double term = r;
+    double sum = r;
+
+    for ( int i = 3; i <= 21; i += 2 ) {
+        term = -term * r2 / ( ( i - 1 ) * i );
+        sum = sum + term;
+    }
+
+    return sum;
+
+}
+
+static double cosPolynomial( double r ) {
+
+    double r2 = r * r;
+    double term = 1.0;
+    double sum = 1.0;
+
+    for ( int i = 2; i <= 20; i += 2 ) {
+        term = -term * r2 / ( ( i - 1 ) * i );
+        sum = sum + term;
+    }
+
+    return sum;
+
+}
+
+// hashed byte by byte in little endian order, whatever the host order is
+static uint32_t hashInt( uint32_t hash, int value ) {
+
+    uint32_t v = (uint32_t) value;
+
+    for ( int i = 0; i < 4; i++ ) {
+        hash ^= ( v >> ( i * 8 ) ) & 0xFFu;
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+
+}
+
+static uint32_t hashInts( uint32_t hash, int *values, int count ) {
+
+    for ( int i = 0; i < count; i++ ) {
+        hash = hashInt( hash, values[i] );
+    }
+
+    return hash;
+
+}
+
+static uint32_t hashFloat( uint32_t hash, float value ) {
+
+    int bits;
+    memcpy( &bits, &value, sizeof( bits ) );
+
+    return hashInt( hash, bits );
+
+}
+
+static int cueStickIndex( GameWorld *gw, CueStick *cs ) {
+    if ( cs == &gw->cueStickP1 ) {
+        return 1;
+    } else if ( cs == &gw->cueStickP2 ) {
+        return 2;
+    }
+    return 0;
+}
@@ -9,40 +9,28 @@
 #include <math.h>
 #include <stdbool.h>
 #include <stdlib.h>
-#include <string.h>
 
 #include "raylib/raylib.h"
 
 #include "Ball.h"
+#include "BallMask.h"
 #include "CommonMacros.h"
-#include "CueStick.h"
-#include "Cushion.h"
+#include "Determinism.h"
 #include "EBPRules.h"
-#include "GameWorld.h"
-#include "Pocket.h"
-#include "ResourceManager.h"
+#include "GameRules.h"
 #include "Types.h"
 
-static const Color EBP_YELLOW = { 255, 215, 0,   255 };
-static const Color EBP_BLUE   = { 0,   100, 200, 255 };
-static const Color EBP_RED    = { 220, 20,  60,  255 };
-static const Color EBP_PURPLE = { 75,  0,   130, 255 };
-static const Color EBP_ORANGE = { 255, 100, 0,   255 };
-static const Color EBP_GREEN  = { 0,   128, 0,   255 };
-static const Color EBP_BROWN  = { 139, 69,  19,  255 };
-
 static void applyRulesBreaking( GameWorld *gw );
 static void applyRulesOpenTable( GameWorld *gw );
 static void applyRulesPlaying( GameWorld *gw );
 static void applyRulesBallInHand( GameWorld *gw );
 static bool isFault( GameWorld *gw );
 
-static void shuffleColorsAndNumbers( Color *colors, int *numbers, int size );
-static void prepareBallData( Color *colors, bool *striped, int *numbers, bool suffle );
+static void shuffleColorsAndNumbers( Color *colors, int *numbers, int size, RandomGenerator *rng );
+static void prepareBallData( Color *colors, bool *striped, int *numbers, bool suffle, RandomGenerator *rng );
 
 static int countBallsTouchedCushion( GameWorld *gw );
-static void resetStatistics( GameWorld *gw );
-static bool canTouchBall8( GameWorld *gw );
+static bool canTouchBall8( const GameWorld *gw, const CueStick *cs );
 static bool pocketedBall8( GameWorld *gw );
 static bool pocketedWrongBalls( GameWorld *gw );
 static int countCorrectPocketedBalls( GameWorld *gw );
@@ -59,7 +47,43 @@ void applyRulesEBP( GameWorld *gw ) {
         default: break;
     }
 
-    resetStatistics( gw );
+}
+
+// during the break nobody takes the balls; with the groups known each
+// player takes the balls of their own group and the 8 goes to nobody
+void onEventEBP( GameWorld *gw, const SimulationEvent *event ) {
+
+    if ( event->type != SIMULATION_EVENT_BALL_POCKETED || &gw->balls[event->a] == gw->cueBall || gw->state == GAME_STATE_BREAKING ) {
+        return;
+    }
+
+    BallMask ball = BALL_MASK( gw->balls[event->a].number );
+    CueStick *shooter = gw->currentCueStick;
+    CueStick *opponent = shooter == &gw->cueStickP1 ? &gw->cueStickP2 : &gw->cueStickP1;
+
+    if ( shooter->group == BALL_GROUP_UNDEFINED || ( ball & groupBallMask( shooter->group ) ) ) {
+        shooter->pocketed |= ball;
+    } else if ( ball & opponentGroupBallMask( shooter->group ) ) {
+        opponent->pocketed |= ball;
+    }
+
+}
+
+// any ball on an open table, then the own group and at last the 8
+BallMask legalTargetsEBP( const GameWorld *gw ) {
+
+    const CueStick *cs = gw->currentCueStick;
+    BallMask table = tableBallMask( gw->balls, gw->ballCount ) & ~CUE_BALL_MASK;
+
+    if ( cs->group == BALL_GROUP_UNDEFINED ) {
+        return table;
+    }
+
+    if ( canTouchBall8( gw, cs ) ) {
+        return table & BALL_8_MASK;
+    }
+
+    return table & groupBallMask( cs->group );
 
 }
 
@@ -70,7 +94,7 @@ static void applyRulesBreaking( GameWorld *gw ) {
     if (
         gw->statistics.cueBallHits > 0 &&  
         !gw->statistics.cueBallPocketed &&
-        ( countBallsTouchedCushion( gw ) >= 4 || gw->statistics.pocketedCount > 0 ) 
+        ( countBallsTouchedCushion( gw ) >= 4 || gw->statistics.pocketed != 0 ) 
     ) {
 
         trace( "    ok - valid break" );
@@ -103,7 +127,7 @@ static void applyRulesOpenTable( GameWorld *gw ) {
         return;
     }
         
-    if ( gw->lastCueStick->group == BALL_GROUP_UNDEFINED && gw->statistics.pocketedCount != 0 ) {
+    if ( gw->lastCueStick->group == BALL_GROUP_UNDEFINED && gw->statistics.pocketed != 0 ) {
 
         if ( pocketedBall8( gw ) ) {
             trace( "    ball 8 pocketed in open table - opponent wins!" );
@@ -145,7 +169,7 @@ static void applyRulesOpenTable( GameWorld *gw ) {
         gw->state = GAME_STATE_PLAYING;
         trace( "    open table -> playing" );
 
-    } else if ( gw->statistics.pocketedCount == 0 ) {
+    } else if ( gw->statistics.pocketed == 0 ) {
         trace( "    no balls pocketed - turn ends" );
     }
 
@@ -163,7 +187,7 @@ static void applyRulesPlaying( GameWorld *gw ) {
 
     if ( pocketedBall8( gw ) ) {
 
-        if ( canTouchBall8( gw ) ) {
+        if ( canTouchBall8( gw, gw->lastCueStick ) ) {
             trace( "    ball 8 pocketed legally - player wins!" );
             gw->winnerCueStick = gw->lastCueStick;
             gw->state = GAME_STATE_GAME_OVER;
@@ -206,7 +230,7 @@ static void applyRulesBallInHand( GameWorld *gw ) {
 
     if ( pocketedBall8( gw ) ) {
 
-        if ( canTouchBall8( gw ) ) {
+        if ( canTouchBall8( gw, gw->lastCueStick ) ) {
             trace( "    ball 8 pocketed legally - player wins!" );
             gw->winnerCueStick = gw->lastCueStick;
             gw->state = GAME_STATE_GAME_OVER;
@@ -250,7 +274,7 @@ static bool isFault( GameWorld *gw ) {
     if ( gw->lastCueStick->group != BALL_GROUP_UNDEFINED ) {
 
         // Se pode tocar na bola 8, permite
-        if ( canTouchBall8( gw ) && gw->statistics.cueBallFirstHitNumber == 8 ) {
+        if ( canTouchBall8( gw, gw->lastCueStick ) && gw->statistics.cueBallFirstHitNumber == 8 ) {
             // ok to touch ball 8
         } else if ( gw->lastCueStick->group == BALL_GROUP_SOLID ) {
             if ( gw->statistics.cueBallFirstHitNumber >= 8 ) {
@@ -265,7 +289,7 @@ static bool isFault( GameWorld *gw ) {
         }
     }
 
-    if ( countBallsTouchedCushion( gw ) == 0 && gw->statistics.pocketedCount == 0 ) {
+    if ( gw->statistics.touchedCushion == 0 && gw->statistics.pocketed == 0 ) {
         trace( "    fault: neither cushion hit nor pocketed ball" );
         return true;
     }
@@ -274,92 +298,27 @@ static bool isFault( GameWorld *gw ) {
 
 }
 
-static bool canTouchBall8( GameWorld *gw ) {
-
-    int correctBallsCount = 0;
-
-    if ( gw->lastCueStick->group == BALL_GROUP_SOLID ) {
-        for ( int i = 0; i < gw->lastCueStick->pocketedCount; i++ ) {
-            if ( gw->lastCueStick->pocketedBalls[i] < 8 ) {
-                correctBallsCount++;
-            }
-        }
-    } else if ( gw->lastCueStick->group == BALL_GROUP_STRIPED ) {
-        for ( int i = 0; i < gw->lastCueStick->pocketedCount; i++ ) {
-            if ( gw->lastCueStick->pocketedBalls[i] > 8 ) {
-                correctBallsCount++;
-            }
-        }
-    }
-
-    return correctBallsCount == 7;
-
+// every ball of the group is off the table, whoever pocketed it
+static bool canTouchBall8( const GameWorld *gw, const CueStick *cs ) {
+    BallMask group = groupBallMask( cs->group );
+    return group != 0 && ( tableBallMask( gw->balls, gw->ballCount ) & group ) == 0;
 }
 
 static bool pocketedBall8( GameWorld *gw ) {
-    for ( int i = 0; i < gw->statistics.pocketedCount; i++ ) {
-        if ( gw->statistics.pocketedBalls[i] == 8 ) {
-            return true;
-        }
-    }
-    return false;
+    return ( gw->statistics.pocketed & BALL_8_MASK ) != 0;
 }
 
 static bool pocketedWrongBalls( GameWorld *gw ) {
-
-    if ( gw->lastCueStick->group == BALL_GROUP_UNDEFINED ) {
-        return false;
-    }
-
-    for ( int i = 0; i < gw->statistics.pocketedCount; i++ ) {
-
-        int ballNumber = gw->statistics.pocketedBalls[i];
-
-        if ( ballNumber == 8 ) {
-            continue;
-        }
-
-        if ( gw->lastCueStick->group == BALL_GROUP_SOLID ) {
-            if ( ballNumber > 8 ) {
-                return true;
-            }
-        } else if ( gw->lastCueStick->group == BALL_GROUP_STRIPED ) {
-            if ( ballNumber < 8 ) {
-                return true;
-            }
-        }
-
-    }
-
-    return false;
-
+    return ( gw->statistics.pocketed & opponentGroupBallMask( gw->lastCueStick->group ) ) != 0;
 }
 
 static int countCorrectPocketedBalls( GameWorld *gw ) {
 
     if ( gw->lastCueStick->group == BALL_GROUP_UNDEFINED ) {
-        return gw->statistics.pocketedCount;
+        return countBallMask( gw->statistics.pocketed );
     }
 
-    int count = 0;
-
-    for ( int i = 0; i < gw->statistics.pocketedCount; i++ ) {
-
-        int ballNumber = gw->statistics.pocketedBalls[i];
-
-        if ( ballNumber == 8 ) {
-            continue;
-        }
-
-        if ( gw->lastCueStick->group == BALL_GROUP_SOLID && ballNumber < 8 ) {
-            count++;
-        } else if ( gw->lastCueStick->group == BALL_GROUP_STRIPED && ballNumber > 8 ) {
-            count++;
-        }
-
-    }
-
-    return count;
+    return countBallMask( gw->statistics.pocketed & groupBallMask( gw->lastCueStick->group ) );
 
 }
 
@@ -369,231 +328,27 @@ void setupEBP( GameWorld *gw ) {
     bool striped[15];
     int numbers[15];
 
-    prepareBallData( colors, striped, numbers, SHUFFLE_BALLS );
-
-    gw->boundarie = (Rectangle) {
-        MARGIN,
-        MARGIN,
-        700,
-        350
-    };
-
-    gw->marksSpacing = gw->boundarie.width / 8;
-
-    // pockets
-    // top left
-    gw->pockets[0] = (Pocket) {
-        .center = {
-            gw->boundarie.x - TABLE_MARGIN / 2 + 6, 
-            gw->boundarie.y - TABLE_MARGIN / 2 + 6
-        },
-        .radius = TABLE_MARGIN / 2
-    };
-
-    // top center
-    gw->pockets[1] = (Pocket) {
-        .center = {
-            gw->boundarie.x + gw->boundarie.width / 2, 
-            gw->boundarie.y - TABLE_MARGIN / 2 + 3, 
-        },
-        .radius = TABLE_MARGIN / 2.5f
-    };
-
-    // top right
-    gw->pockets[2] = (Pocket) {
-        .center = {
-            gw->boundarie.x + gw->boundarie.width + TABLE_MARGIN / 2 - 6, 
-            gw->boundarie.y - TABLE_MARGIN / 2 + 6
-        },
-        .radius = TABLE_MARGIN / 2
-    };
-
-    // bottom left
-    gw->pockets[3] = (Pocket) {
-        .center = {
-            gw->boundarie.x - TABLE_MARGIN / 2 + 6, 
-            gw->boundarie.y + gw->boundarie.height + TABLE_MARGIN / 2 - 6
-        },
-        .radius = TABLE_MARGIN / 2
-    };
-
-    // bottom center
-    gw->pockets[4] = (Pocket) {
-        .center = {
-            gw->boundarie.x + gw->boundarie.width / 2, 
-            gw->boundarie.y + gw->boundarie.height + TABLE_MARGIN / 2 - 3
-        },
-        .radius = TABLE_MARGIN / 2.5f
-    };
-
-    // bottom right
-    gw->pockets[5] = (Pocket) {
-        .center = {
-            gw->boundarie.x + gw->boundarie.width + TABLE_MARGIN / 2 - 6, 
-            gw->boundarie.y + gw->boundarie.height + TABLE_MARGIN / 2 - 6
-        },
-        .radius = TABLE_MARGIN / 2
-    };
-
-    // top left
-    gw->cushions[0] = (Cushion) {
-        {
-            { 105, 86 },
-            { 435, 86 },
-            { 430, 100 },
-            { 120, 100 }
-        }
-    };
-
-    // top right
-    gw->cushions[1] = (Cushion) {
-        {
-            { 465, 86 },
-            { 795, 86 },
-            { 780, 100 },
-            { 470, 100 }
-        }
-    };
-
-    // bottom left
-    gw->cushions[2] = (Cushion) {
-        {
-            { 120, 450 },
-            { 430, 450 },
-            { 435, 464 },
-            { 105, 464 }
-        }
-    };
-
-    // bottom right
-    gw->cushions[3] = (Cushion) {
-        {
-            { 470, 450 },
-            { 780, 450 },
-            { 795, 464 },
-            { 465, 464 }
-        }
-    };
-
-    // head
-    gw->cushions[4] = (Cushion) {
-        {
-            { 86, 105 },
-            { 100, 120 },
-            { 100, 430 },
-            { 86, 445 }
-        }
-    };
-
-    // foot
-    gw->cushions[5] = (Cushion) {
-        {
-            { 800, 120 },
-            { 814, 105 },
-            { 814, 445 },
-            { 800, 430 }
-        }
-    };
-
-    // cue ball
-    gw->cueBall = &gw->balls[0];
-    gw->balls[0] = (Ball) {
-        .center = { gw->boundarie.x + gw->boundarie.width / 4, GetScreenHeight() / 2 },
-        .spin = { 0, 0 },
-        .radius = BALL_RADIUS,
-        .vel = { 0, 0 },
-        .friction = BALL_FRICTION,
-        .elasticity = BALL_ELASTICITY,
-        .color = WHITE,
-        .striped = false,
-        .number = 0,
-        .pocketed = false
-    };
-    gw->balls[0].prevPos = gw->balls[0].center;
-    
-    for ( int i = 1; i <= BALL_COUNT; i++ ) {
-        gw->balls[i] = (Ball) {
-            .center = { 0, 0 },
-            .spin = { 0, 0 },
-            .prevPos = { 0 },
-            .radius = BALL_RADIUS,
-            .vel = { 0, 0 },
-            .friction = BALL_FRICTION,
-            .elasticity = BALL_ELASTICITY,
-            .color = colors[i-1],
-            .striped = striped[i-1],
-            .number = numbers[i-1],
-            .pocketed = false
-        };
+    prepareBallData( colors, striped, numbers, SHUFFLE_BALLS, &gw->rng );
+
+    setupTable( gw, GAME_RULES_EIGHT_BALL );
+
+    for ( int i = 1; i < gw->ballCount; i++ ) {
+        gw->balls[i].color = colors[i-1];
+        gw->balls[i].striped = striped[i-1];
+        gw->balls[i].number = numbers[i-1];
     }
 
     if ( TEST_BALL_POSITIONING ) {
-        performTestBallPositioning( gw->balls, BALL_RADIUS, gw->boundarie );
+        performTestBallPositioning( gw->balls, gw->cueBall->radius, gw->boundarie );
     } else {
-        performDefaultBallPositioning( gw->balls, BALL_RADIUS, gw->boundarie );
+        performDefaultBallPositioning( gw->balls, gw->cueBall->radius, gw->boundarie );
     }
-    
-    int initPower = 400;
-    int powerTick = 10;
-    int maxPower = 1400;
-
-    gw->cueStickP1 = (CueStick) {
-        .target = gw->cueBall->center,
-        .distanceFromTarget = BALL_RADIUS,
-        .size = 300,
-        .angle = 0,
-        .powerTick = powerTick,
-        .power = initPower,
-        .minPower = 0,
-        .maxPower = maxPower,
-        .hitPoint = { 0, 0 },
-        .color = { 17, 50, 102, 255 },
-        .pocketedBalls = { 0 },
-        .pocketedCount = 0,
-        /*.pocketedBalls = { 1, 2, 3, 4, 5, 6, 7 },
-        .pocketedCount = 7,*/
-        .type = CUE_STICK_TYPE_P1,
-        .state = CUE_STICK_STATE_READY,
-        .group = BALL_GROUP_UNDEFINED
-    };
-
-    gw->cueStickP2 = (CueStick) {
-        .target = gw->cueBall->center,
-        .distanceFromTarget = BALL_RADIUS,
-        .size = 300,
-        .angle = 0,
-        .powerTick = powerTick,
-        .power = initPower,
-        .minPower = 0,
-        .maxPower = maxPower,
-        .hitPoint = { 0, 0 },
-        .color = { 102, 17, 37, 255 },
-        .pocketedBalls = { 0 },
-        .pocketedCount = 0,
-        /*.pocketedBalls = { 9, 10, 11, 12, 13, 14, 15 },
-        .pocketedCount = 7,*/
-        .type = CUE_STICK_TYPE_P2,
-        .state = CUE_STICK_STATE_READY,
-        .group = BALL_GROUP_UNDEFINED
-    };
-
-    gw->currentCueStick = &gw->cueStickP1;
-    gw->winnerCueStick = NULL;
-    gw->lastCueStick = NULL;
-
-    gw->state = GAME_STATE_BREAKING;
-    gw->ballsState = GAME_STATE_BALLS_STOPPED;
-    gw->pocketedCount = 0;
-
-    resetStatistics( gw );
-
-    gw->applyRules = false;
 
 }
 
-static void shuffleColorsAndNumbers( Color *colors, int *numbers, int size ) {
+static void shuffleColorsAndNumbers( Color *colors, int *numbers, int size, RandomGenerator *rng ) {
     for ( int i = 0; i < size; i++ ) {
-        int p = GetRandomValue( 0, size - 1 );
+        int p = nextRandomValue( rng, 0, size - 1 );
         Color c = colors[i];
         colors[i] = colors[p];
         colors[p] = c;
@@ -603,33 +358,23 @@ static void shuffleColorsAndNumbers( Color *colors, int *numbers, int size ) {
     }
 }
 
-static void prepareBallData( Color *colors, bool *striped, int *numbers, bool suffle ) {
-
-    Color solidColors[] = {
-        EBP_YELLOW,
-        EBP_BLUE,
-        EBP_RED,
-        EBP_PURPLE,
-        EBP_ORANGE,
-        EBP_GREEN,
-        EBP_BROWN
-    };
-    int solidNumbers[] = { 1, 2, 3, 4, 5, 6, 7 };
-
-    Color stripeColors[] = {
-        EBP_YELLOW,
-        EBP_BLUE,
-        EBP_RED,
-        EBP_PURPLE,
-        EBP_ORANGE,
-        EBP_GREEN,
-        EBP_BROWN
-    };
-    int stripeNumbers[] = { 9, 10, 11, 12, 13, 14, 15 };
+static void prepareBallData( Color *colors, bool *striped, int *numbers, bool suffle, RandomGenerator *rng ) {
+
+    Color solidColors[7];
+    int solidNumbers[7];
+    Color stripeColors[7];
+    int stripeNumbers[7];
+
+    for ( int i = 0; i < 7; i++ ) {
+        solidNumbers[i] = i + 1;
+        solidColors[i] = ballColor( solidNumbers[i] );
+        stripeNumbers[i] = i + 9;
+        stripeColors[i] = ballColor( stripeNumbers[i] );
+    }
 
     if ( suffle ) {
-        shuffleColorsAndNumbers( solidColors, solidNumbers, 7 );
-        shuffleColorsAndNumbers( stripeColors, stripeNumbers, 7 );
+        shuffleColorsAndNumbers( solidColors, solidNumbers, 7, rng );
+        shuffleColorsAndNumbers( stripeColors, stripeNumbers, 7, rng );
     }
 
     Color colorQueue[12];
@@ -643,7 +388,7 @@ static void prepareBallData( Color *colors, bool *striped, int *numbers, bool su
     }
 
     if ( suffle ) {
-        shuffleColorsAndNumbers( colorQueue, numberQueue, 12 );
+        shuffleColorsAndNumbers( colorQueue, numberQueue, 12, rng );
     }
 
     int q = 0;
@@ -695,31 +440,5 @@ static void prepareBallData( Color *colors, bool *striped, int *numbers, bool su
 }
 
 static int countBallsTouchedCushion( GameWorld *gw ) {
-
-    int cHits = 0 ;
-
-    for ( int i = 0; i < 16; i++ ) {
-        if ( gw->statistics.ballsTouchedCushion[i] ) {
-            cHits++;
-        }
-    }
-
-    return cHits;
-
-}
-
-static void resetStatistics( GameWorld *gw ) {
-
-    gw->statistics.cueBallHits = 0;
-    gw->statistics.cueBallFirstHitNumber = 0;
-    gw->statistics.cueBallPocketed = false;
-    gw->statistics.pocketedCount = 0;
-    
-    memset( gw->statistics.ballsTouchedCushion, false, sizeof( gw->statistics.ballsTouchedCushion ) );
-
-}
-
-void resetCueBallPosition( GameWorld *gw ) {
-    gw->cueBall->center = (Vector2) { gw->boundarie.x + gw->boundarie.width / 4, GetScreenHeight() / 2 };
-    gw->cueBall->pocketed = false;
+    return countBallMask( gw->statistics.touchedCushion );
 }
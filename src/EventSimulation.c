@@ -0,0 +1,504 @@
+/**
+ * @file EventSimulation.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Event driven (time of impact) shot simulation implementation.
+ *
+ * Between two events every ball moves with v(t) = v0 * e^(-kt), so its
+ * displacement is v0 * s(t), with s(t) = ( 1 - e^(-kt) ) / k. All the balls
+ * share the same friction, hence the same s(t), and the distance between two
+ * balls (or between a ball and a cushion edge, vertex or pocket) is a
+ * quadratic function of s. Each contact time is then one square root away.
+ * The motion itself comes from BallMotion and the balls are the lanes of
+ * the physics state the stepper works on.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+
+#include "BallBatch.h"
+#include "BallMotion.h"
+#include "CommonMacros.h"
+#include "ContactSolver.h"
+#include "EventSimulation.h"
+#include "Simulation.h"
+#include "SimulationEvents.h"
+#include "Types.h"
+
+// balls are taken to the contact slightly overlapped, as the solver
+// only acts on touching balls
+#define CONTACT_EPSILON 0.01f
+
+typedef enum ShotEventType {
+    SHOT_EVENT_BALL_BALL,
+    SHOT_EVENT_BALL_CUSHION,
+    SHOT_EVENT_BALL_POCKET,
+    SHOT_EVENT_BALL_STOP
+} ShotEventType;
+
+typedef struct ShotEvent {
+    float time;
+    ShotEventType type;
+    int ballA;
+    int ballB;          // ball x ball only
+    int versionA;
+    int versionB;
+    Vector2 normal;     // ball x cushion only
+} ShotEvent;
+
+typedef struct EventQueue {
+    ShotEvent *events;
+    int count;
+    int capacity;
+    bool failed;        // an event was lost, there was no memory to grow
+} EventQueue;
+
+typedef struct EventSimulator {
+    GameWorld *gw;
+    BallBatch *bb;
+    EventQueue queue;
+    int versions[BALL_CAPACITY];
+    float now;
+} EventSimulator;
+
+static void pushEvent( EventQueue *q, ShotEvent e );
+static ShotEvent popEvent( EventQueue *q );
+
+static void predictBall( EventSimulator *sim, int i );
+static void predictBallBall( EventSimulator *sim, const Ball *b1, int i, int j );
+static void predictBallCushions( EventSimulator *sim, const Ball *b, int i );
+static void predictBallPockets( EventSimulator *sim, const Ball *b, int i );
+static void advanceBalls( EventSimulator *sim, float time );
+static void processEvent( EventSimulator *sim, ShotEvent *e );
+static void collideBalls( EventSimulator *sim, int a, int b, bool *affected );
+static void updateBallState( EventSimulator *sim, int i );
+
+int resolveShotEvents( GameWorld *gw ) {
+
+    EventSimulator sim = {
+        .gw = gw,
+        .bb = &gw->physics,
+        .queue = { 0 },
+        .versions = { 0 },
+        .now = 0.0f
+    };
+
+    BallBatch *bb = sim.bb;
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        bb->moving[i] = !bb->pocketed[i] && Vector2Length( (Vector2) { bb->vx[i], bb->vy[i] } ) >= BALL_STOP_SPEED ? -1 : 0;
+        if ( !bb->moving[i] ) {
+            bb->vx[i] = bb->vy[i] = 0.0f;
+        }
+    }
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        predictBall( &sim, i );
+    }
+
+    int processed = 0;
+
+    while ( sim.queue.count > 0 && !sim.queue.failed && processed < EVENT_SIMULATION_MAX_EVENTS ) {
+
+        ShotEvent e = popEvent( &sim.queue );
+
+        // stale event: one of the balls changed its trajectory after the prediction
+        if ( e.versionA != sim.versions[e.ballA] ||
+             ( e.type == SHOT_EVENT_BALL_BALL && e.versionB != sim.versions[e.ballB] ) ) {
+            continue;
+        }
+
+        advanceBalls( &sim, e.time );
+        processEvent( &sim, &e );
+        applySimulationEvents( gw );
+        processed++;
+
+    }
+
+    bool finished = sim.queue.count == 0 && !sim.queue.failed;
+    free( sim.queue.events );
+
+    // degenerate clusters that keep generating contacts, or a queue that
+    // could not grow, are finished by stepping from where the events stopped
+    if ( !finished ) {
+        gw->ballsState = GAME_STATE_BALLS_MOVING;
+        for ( int i = 0; i < SIMULATION_MAX_SHOT_STEPS && gw->ballsState == GAME_STATE_BALLS_MOVING; i++ ) {
+            simulateNextStep( gw );
+        }
+    }
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        bb->px[i] = bb->x[i];
+        bb->py[i] = bb->y[i];
+    }
+
+    storeBallBatch( bb, gw->balls, gw->ballCount );
+
+    gw->ballsState = GAME_STATE_BALLS_STOPPED;
+    gw->currentCueStick->target = gw->cueBall->center;
+
+    return processed;
+
+}
+
+int simulateShotEvents( GameWorld *gw, float angle, int power, Vector2 hitPoint ) {
+
+    CueStick *cc = gw->currentCueStick;
+    cc->angle = angle;
+    cc->power = power;
+    cc->hitPoint = hitPoint;
+
+    strikeCueBall( gw );
+    int processed = resolveShotEvents( gw );
+    finishShot( gw );
+
+    return processed;
+
+}
+
+static void predictBall( EventSimulator *sim, int i ) {
+
+    GameWorld *gw = sim->gw;
+    BallBatch *bb = sim->bb;
+
+    if ( bb->pocketed[i] ) {
+        return;
+    }
+
+    // BallMotion works on a Ball, taken with the state of the lane
+    Ball b = ballFromBatch( bb, gw->balls, i );
+
+    for ( int j = 0; j < gw->ballCount; j++ ) {
+        if ( j != i && !bb->pocketed[j] && ( bb->moving[i] || bb->moving[j] ) ) {
+            predictBallBall( sim, &b, i, j );
+        }
+    }
+
+    if ( bb->moving[i] ) {
+
+        predictBallCushions( sim, &b, i );
+        predictBallPockets( sim, &b, i );
+
+        pushEvent( &sim->queue, (ShotEvent) {
+            .time = sim->now + ballTimeToStop( &b ),
+            .type = SHOT_EVENT_BALL_STOP,
+            .ballA = i,
+            .versionA = sim->versions[i]
+        });
+
+    }
+
+}
+
+static void predictBallBall( EventSimulator *sim, const Ball *b1, int i, int j ) {
+
+    Ball b2 = ballFromBatch( sim->bb, sim->gw->balls, j );
+
+    Vector2 d0 = Vector2Subtract( b2.center, b1->center );
+    Vector2 dv = Vector2Subtract( b1->vel, b2.vel );
+
+    float s = firstContactDisplacement( d0, dv, b1->radius + b2.radius - CONTACT_EPSILON );
+
+    // the prediction is only valid until one of them stops
+    float sLimit = INFINITY;
+    if ( b1->moving ) {
+        sLimit = fminf( sLimit, ballStopDisplacement( b1 ) );
+    }
+    if ( b2.moving ) {
+        sLimit = fminf( sLimit, ballStopDisplacement( &b2 ) );
+    }
+
+    if ( s > sLimit ) {
+        return;
+    }
+
+    pushEvent( &sim->queue, (ShotEvent) {
+        .time = sim->now + ballTimeForDisplacement( b1, s ),
+        .type = SHOT_EVENT_BALL_BALL,
+        .ballA = i,
+        .ballB = j,
+        .versionA = sim->versions[i],
+        .versionB = sim->versions[j]
+    });
+
+}
+
+static void predictBallCushions( EventSimulator *sim, const Ball *b, int i ) {
+
+    float sLimit = ballStopDisplacement( b );
+    float sMin = INFINITY;
+    Vector2 normal = { 0 };
+
+    for ( int c = 0; c < 6; c++ ) {
+
+        Cushion *cushion = &sim->gw->cushions[c];
+        Vector2 *vertices = cushion->vertices;
+
+        for ( int e = 0; e < 4; e++ ) {
+
+            Vector2 start = vertices[e];
+            Vector2 segNorm = cushion->edgeDirections[e];
+            Vector2 edgeNormal = cushion->edgeNormals[e];
+            float segLen = cushion->edgeLengths[e];
+
+            float dist = Vector2DotProduct( Vector2Subtract( b->center, start ), edgeNormal );
+            float approach = Vector2DotProduct( b->vel, edgeNormal );
+
+            // behind the edge or moving away from it
+            if ( dist < 0.0f || approach >= 0.0f ) {
+                continue;
+            }
+
+            float s = fmaxf( ( b->radius - dist ) / approach, 0.0f );
+
+            if ( s < sMin && s <= sLimit ) {
+                Vector2 contactCenter = Vector2Add( b->center, Vector2Scale( b->vel, s ) );
+                float projection = Vector2DotProduct( Vector2Subtract( contactCenter, start ), segNorm );
+                if ( projection >= 0.0f && projection <= segLen ) {
+                    sMin = s;
+                    normal = edgeNormal;
+                }
+            }
+
+        }
+
+        for ( int v = 0; v < 4; v++ ) {
+
+            float s = firstContactDisplacement( Vector2Subtract( vertices[v], b->center ), b->vel, b->radius );
+
+            if ( s < sMin && s <= sLimit ) {
+                Vector2 contactCenter = Vector2Add( b->center, Vector2Scale( b->vel, s ) );
+                sMin = s;
+                normal = Vector2Normalize( Vector2Subtract( contactCenter, vertices[v] ) );
+            }
+
+        }
+
+    }
+
+    if ( sMin != INFINITY ) {
+        pushEvent( &sim->queue, (ShotEvent) {
+            .time = sim->now + ballTimeForDisplacement( b, sMin ),
+            .type = SHOT_EVENT_BALL_CUSHION,
+            .ballA = i,
+            .versionA = sim->versions[i],
+            .normal = normal
+        });
+    }
+
+}
+
+static void predictBallPockets( EventSimulator *sim, const Ball *b, int i ) {
+
+    float sLimit = ballStopDisplacement( b );
+    float sMin = INFINITY;
+
+    for ( int p = 0; p < 6; p++ ) {
+
+        Pocket *pocket = &sim->gw->pockets[p];
+
+        // more than 50% of ball is inside the pocket
+        float captureRadius = pocket->radius - b->radius * 0.5f;
+        float s = firstContactDisplacement( Vector2Subtract( pocket->center, b->center ), b->vel, captureRadius );
+
+        if ( s < sMin && s <= sLimit ) {
+            sMin = s;
+        }
+
+    }
+
+    if ( sMin != INFINITY ) {
+        pushEvent( &sim->queue, (ShotEvent) {
+            .time = sim->now + ballTimeForDisplacement( b, sMin ),
+            .type = SHOT_EVENT_BALL_POCKET,
+            .ballA = i,
+            .versionA = sim->versions[i]
+        });
+    }
+
+}
+
+static void advanceBalls( EventSimulator *sim, float time ) {
+
+    float tau = time - sim->now;
+    BallBatch *bb = sim->bb;
+
+    if ( tau > 0.0f ) {
+
+        for ( int i = 0; i < sim->gw->ballCount; i++ ) {
+            if ( bb->moving[i] ) {
+                Ball b = ballFromBatch( bb, sim->gw->balls, i );
+                BallMotionState m = ballMotionAt( &b, tau );
+                bb->x[i] = m.center.x;
+                bb->y[i] = m.center.y;
+                bb->vx[i] = m.vel.x;
+                bb->vy[i] = m.vel.y;
+                bb->sx[i] = m.spin.x;
+                bb->sy[i] = m.spin.y;
+            }
+        }
+
+        sim->now = time;
+
+    }
+
+}
+
+static void processEvent( EventSimulator *sim, ShotEvent *e ) {
+
+    GameWorld *gw = sim->gw;
+    BallBatch *bb = sim->bb;
+    bool affected[BALL_CAPACITY] = { false };
+
+    affected[e->ballA] = true;
+
+    switch ( e->type ) {
+
+        case SHOT_EVENT_BALL_BALL:
+            collideBalls( sim, e->ballA, e->ballB, affected );
+            break;
+
+        case SHOT_EVENT_BALL_CUSHION:
+            collideBallWithCushion( gw, e->ballA, e->normal );
+            break;
+
+        case SHOT_EVENT_BALL_POCKET:
+            pocketBall( gw, e->ballA );
+            break;
+
+        case SHOT_EVENT_BALL_STOP:
+            bb->vx[e->ballA] = bb->vy[e->ballA] = 0.0f;
+            break;
+
+    }
+
+    // every ball the event changed goes on a new path, its old predictions are stale
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        if ( affected[i] ) {
+            updateBallState( sim, i );
+        }
+    }
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        if ( affected[i] ) {
+            predictBall( sim, i );
+        }
+    }
+
+}
+
+// the group of balls touching the pair is solved together, as in a step
+static void collideBalls( EventSimulator *sim, int a, int b, bool *affected ) {
+
+    GameWorld *gw = sim->gw;
+    BallBatch *bb = sim->bb;
+    BallContact contacts[CONTACT_SOLVER_MAX_CONTACTS];
+    int candidates[BALL_CAPACITY];
+    int candidateCount = 0;
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        if ( !bb->pocketed[i] ) {
+            candidates[candidateCount++] = i;
+        }
+    }
+
+    beginContactSolverStep( &gw->contactSolver );
+    int contactCount = solveBallContacts( &gw->contactSolver, bb, candidates, candidateCount, a, b, contacts );
+
+    for ( int i = 0; i < contactCount; i++ ) {
+        BallContact *c = &contacts[i];
+        affected[c->a] = affected[c->b] = true;
+        if ( c->impulse > 0.0f ) {
+            pushSimulationEvent( &gw->events, (SimulationEvent) {
+                .type = SIMULATION_EVENT_BALL_HIT,
+                .a = (uint8_t) c->a,
+                .b = (uint8_t) c->b,
+                .value = c->impulse
+            });
+        }
+    }
+
+    affected[b] = true;
+
+}
+
+// a ball slower than the stop speed rests, as the stepper would stop it
+static void updateBallState( EventSimulator *sim, int i ) {
+
+    BallBatch *bb = sim->bb;
+    bool wasMoving = bb->moving[i] != 0;
+    bool moving = !bb->pocketed[i] && Vector2Length( (Vector2) { bb->vx[i], bb->vy[i] } ) >= BALL_STOP_SPEED;
+
+    if ( !moving ) {
+        bb->vx[i] = bb->vy[i] = 0.0f;
+        bb->sx[i] = bb->sy[i] = 0.0f;
+        if ( wasMoving && !bb->pocketed[i] ) {
+            pushSimulationEvent( &sim->gw->events, (SimulationEvent) {
+                .type = SIMULATION_EVENT_BALL_STOPPED,
+                .a = (uint8_t) i
+            });
+        }
+    }
+
+    bb->moving[i] = moving ? -1 : 0;
+    sim->versions[i]++;
+
+}
+
+static void pushEvent( EventQueue *q, ShotEvent e ) {
+
+    if ( q->count == q->capacity ) {
+        int capacity = q->capacity == 0 ? 256 : q->capacity * 2;
+        ShotEvent *events = (ShotEvent*) realloc( q->events, sizeof( ShotEvent ) * capacity );
+        if ( events == NULL ) {
+            q->failed = true;
+            return;
+        }
+        q->events = events;
+        q->capacity = capacity;
+    }
+
+    // binary min heap on time
+    int i = q->count++;
+    while ( i > 0 ) {
+        int parent = ( i - 1 ) / 2;
+        if ( q->events[parent].time <= e.time ) {
+            break;
+        }
+        q->events[i] = q->events[parent];
+        i = parent;
+    }
+    q->events[i] = e;
+
+}
+
+static ShotEvent popEvent( EventQueue *q ) {
+
+    ShotEvent top = q->events[0];
+    ShotEvent last = q->events[--q->count];
+
+    int i = 0;
+    while ( true ) {
+        int child = 2 * i + 1;
+        if ( child >= q->count ) {
+            break;
+        }
+        if ( child + 1 < q->count && q->events[child+1].time < q->events[child].time ) {
+            child++;
+        }
+        if ( last.time <= q->events[child].time ) {
+            break;
+        }
+        q->events[i] = q->events[child];
+        i = child;
+    }
+    q->events[i] = last;
+
+    return top;
+
+}
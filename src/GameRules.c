@@ -0,0 +1,353 @@
+/**
+ * @file GameRules.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Game rules implementation: the table every game shares and the
+ * rules of each game.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "raylib/raylib.h"
+
+#include "BallBatch.h"
+#include "Broadphase.h"
+#include "CommonMacros.h"
+#include "ContactSolver.h"
+#include "Cushion.h"
+#include "EBPRules.h"
+#include "GameRules.h"
+#include "NineBallRules.h"
+#include "Simulation.h"
+#include "SimulationEvents.h"
+#include "SnookerRules.h"
+#include "Types.h"
+
+static const Color BALL_YELLOW = { 255, 215, 0,   255 };
+static const Color BALL_BLUE   = { 0,   100, 200, 255 };
+static const Color BALL_RED    = { 220, 20,  60,  255 };
+static const Color BALL_PURPLE = { 75,  0,   130, 255 };
+static const Color BALL_ORANGE = { 255, 100, 0,   255 };
+static const Color BALL_GREEN  = { 0,   128, 0,   255 };
+static const Color BALL_BROWN  = { 139, 69,  19,  255 };
+
+static bool isGameOverByState( const GameWorld *gw );
+
+// indexed by GameRulesType
+static const GameRules gameRules[GAME_RULES_COUNT] = {
+    {
+        .name = "8 Ball",
+        .layout = POOL_TABLE_LAYOUT,
+        .setup = setupEBP,
+        .onEvent = onEventEBP,
+        .onShotEnd = applyRulesEBP,
+        .legalTargets = legalTargetsEBP,
+        .isGameOver = isGameOverByState
+    },
+    {
+        .name = "9 Ball",
+        .layout = POOL_TABLE_LAYOUT,
+        .setup = setupNineBall,
+        .onEvent = onEventNineBall,
+        .onShotEnd = applyRulesNineBall,
+        .legalTargets = legalTargetsNineBall,
+        .isGameOver = isGameOverByState
+    },
+    {
+        .name = "Snooker",
+        .layout = SNOOKER_TABLE_LAYOUT,
+        .setup = setupSnooker,
+        .onEvent = onEventSnooker,
+        .onShotEnd = applyRulesSnooker,
+        .legalTargets = legalTargetsSnooker,
+        .isGameOver = isGameOverByState
+    }
+};
+
+const GameRules *getGameRules( GameRulesType type ) {
+    return &gameRules[type];
+}
+
+void setupGame( GameWorld *gw, GameRulesType type ) {
+    getGameRules( type )->setup( gw );
+    loadBallBatch( &gw->physics, gw->balls, gw->ballCount );
+}
+
+void setupTable( GameWorld *gw, GameRulesType type ) {
+
+    TableLayout layout = getGameRules( type )->layout;
+
+    gw->rulesType = type;
+    gw->ballCount = layout.ballCount;
+
+    gw->boundarie = (Rectangle) {
+        MARGIN,
+        MARGIN,
+        layout.width,
+        layout.height
+    };
+
+    gw->marksSpacing = gw->boundarie.width / 8;
+
+    float x0 = gw->boundarie.x;
+    float y0 = gw->boundarie.y;
+    float x1 = gw->boundarie.x + gw->boundarie.width;
+    float y1 = gw->boundarie.y + gw->boundarie.height;
+    float xc = gw->boundarie.x + gw->boundarie.width / 2;
+
+    // pool sizes, scaled: cushion depth, corner and side gaps at the back
+    // and at the face of the cushions
+    float s = layout.pocketScale;
+    float depth = 14 * s;
+    float cornerBack = 5 * s;
+    float cornerFace = 20 * s;
+    float sideBack = 15 * s;
+    float sideFace = 20 * s;
+    int cornerRadius = (int) ( TABLE_MARGIN / 2 * s );
+    int sideRadius = (int) ( TABLE_MARGIN / 2.5f * s );
+
+    // pockets
+    // top left
+    gw->pockets[0] = (Pocket) {
+        .center = { x0 - depth, y0 - depth },
+        .radius = cornerRadius
+    };
+
+    // top center
+    gw->pockets[1] = (Pocket) {
+        .center = { xc, y0 - 17 * s },
+        .radius = sideRadius
+    };
+
+    // top right
+    gw->pockets[2] = (Pocket) {
+        .center = { x1 + depth, y0 - depth },
+        .radius = cornerRadius
+    };
+
+    // bottom left
+    gw->pockets[3] = (Pocket) {
+        .center = { x0 - depth, y1 + depth },
+        .radius = cornerRadius
+    };
+
+    // bottom center
+    gw->pockets[4] = (Pocket) {
+        .center = { xc, y1 + 17 * s },
+        .radius = sideRadius
+    };
+
+    // bottom right
+    gw->pockets[5] = (Pocket) {
+        .center = { x1 + depth, y1 + depth },
+        .radius = cornerRadius
+    };
+
+    // top left
+    gw->cushions[0] = (Cushion) {
+        .vertices = {
+            { x0 + cornerBack, y0 - depth },
+            { xc - sideBack, y0 - depth },
+            { xc - sideFace, y0 },
+            { x0 + cornerFace, y0 }
+        }
+    };
+
+    // top right
+    gw->cushions[1] = (Cushion) {
+        .vertices = {
+            { xc + sideBack, y0 - depth },
+            { x1 - cornerBack, y0 - depth },
+            { x1 - cornerFace, y0 },
+            { xc + sideFace, y0 }
+        }
+    };
+
+    // bottom left
+    gw->cushions[2] = (Cushion) {
+        .vertices = {
+            { x0 + cornerFace, y1 },
+            { xc - sideFace, y1 },
+            { xc - sideBack, y1 + depth },
+            { x0 + cornerBack, y1 + depth }
+        }
+    };
+
+    // bottom right
+    gw->cushions[3] = (Cushion) {
+        .vertices = {
+            { xc + sideFace, y1 },
+            { x1 - cornerFace, y1 },
+            { x1 - cornerBack, y1 + depth },
+            { xc + sideBack, y1 + depth }
+        }
+    };
+
+    // head
+    gw->cushions[4] = (Cushion) {
+        .vertices = {
+            { x0 - depth, y0 + cornerBack },
+            { x0, y0 + cornerFace },
+            { x0, y1 - cornerFace },
+            { x0 - depth, y1 - cornerBack }
+        }
+    };
+
+    // foot
+    gw->cushions[5] = (Cushion) {
+        .vertices = {
+            { x1, y0 + cornerFace },
+            { x1 + depth, y0 + cornerBack },
+            { x1 + depth, y1 - cornerBack },
+            { x1, y1 - cornerFace }
+        }
+    };
+
+    for ( int i = 0; i < 6; i++ ) {
+        setupCushion( &gw->cushions[i] );
+    }
+
+    // cue ball
+    gw->cueBall = &gw->balls[0];
+    gw->balls[0] = (Ball) {
+        .center = { gw->boundarie.x + gw->boundarie.width * layout.cueBallSpot, gw->boundarie.y + gw->boundarie.height / 2 },
+        .spin = { 0, 0 },
+        .radius = layout.ballRadius,
+        .vel = { 0, 0 },
+        .friction = BALL_FRICTION,
+        .elasticity = BALL_ELASTICITY,
+        .color = WHITE,
+        .striped = false,
+        .plain = false,
+        .number = 0,
+        .pocketed = false
+    };
+    gw->balls[0].prevPos = gw->balls[0].center;
+
+    for ( int i = 1; i < gw->ballCount; i++ ) {
+        gw->balls[i] = (Ball) {
+            .center = { 0, 0 },
+            .spin = { 0, 0 },
+            .prevPos = { 0 },
+            .radius = layout.ballRadius,
+            .vel = { 0, 0 },
+            .friction = BALL_FRICTION,
+            .elasticity = BALL_ELASTICITY,
+            .color = ballColor( i ),
+            .striped = i > 8,
+            .plain = false,
+            .number = i,
+            .pocketed = false
+        };
+    }
+
+    int initPower = 400;
+    int powerTick = 10;
+    int maxPower = 1400;
+
+    gw->cueStickP1 = (CueStick) {
+        .target = gw->cueBall->center,
+        .distanceFromTarget = layout.ballRadius,
+        .size = 300,
+        .angle = 0,
+        .powerTick = powerTick,
+        .power = initPower,
+        .minPower = 0,
+        .maxPower = maxPower,
+        .hitPoint = { 0, 0 },
+        .color = { 17, 50, 102, 255 },
+        .pocketed = 0,
+        //.pocketed = SOLID_BALLS_MASK,
+        .score = 0,
+        .type = CUE_STICK_TYPE_P1,
+        .state = CUE_STICK_STATE_READY,
+        .group = BALL_GROUP_UNDEFINED
+    };
+
+    gw->cueStickP2 = (CueStick) {
+        .target = gw->cueBall->center,
+        .distanceFromTarget = layout.ballRadius,
+        .size = 300,
+        .angle = 0,
+        .powerTick = powerTick,
+        .power = initPower,
+        .minPower = 0,
+        .maxPower = maxPower,
+        .hitPoint = { 0, 0 },
+        .color = { 102, 17, 37, 255 },
+        .pocketed = 0,
+        //.pocketed = STRIPED_BALLS_MASK,
+        .score = 0,
+        .type = CUE_STICK_TYPE_P2,
+        .state = CUE_STICK_STATE_READY,
+        .group = BALL_GROUP_UNDEFINED
+    };
+
+    gw->currentCueStick = &gw->cueStickP1;
+    gw->winnerCueStick = NULL;
+    gw->lastCueStick = NULL;
+
+    gw->state = GAME_STATE_BREAKING;
+    gw->ballsState = GAME_STATE_BALLS_STOPPED;
+    gw->pocketedCount = 0;
+
+    resetTurnStatistics( gw );
+
+    gw->applyRules = false;
+    gw->ballsOn = 0;
+
+    setupSimulationClock( &gw->clock, PHYSICS_FRAME_RATE, PHYSICS_QUALITY, PHYSICS_MAX_STEPS_PER_FRAME );
+    setupBroadphase( &gw->broadphase );
+    setupContactSolver( &gw->contactSolver );
+    setupSimulationEvents( &gw->events );
+
+}
+
+Color ballColor( int number ) {
+
+    Color colors[] = {
+        BALL_YELLOW,
+        BALL_BLUE,
+        BALL_RED,
+        BALL_PURPLE,
+        BALL_ORANGE,
+        BALL_GREEN,
+        BALL_BROWN
+    };
+
+    if ( number == 0 ) {
+        return WHITE;
+    } else if ( number == 8 ) {
+        return BLACK;
+    }
+
+    return colors[( number - 1 ) % 8];
+
+}
+
+Vector2 footSpot( const GameWorld *gw ) {
+    return (Vector2) { gw->boundarie.x + gw->boundarie.width - gw->boundarie.width / 4, gw->boundarie.y + gw->boundarie.height / 2 };
+}
+
+void resetCueBallPosition( GameWorld *gw ) {
+    float spot = getGameRules( gw->rulesType )->layout.cueBallSpot;
+    gw->cueBall->center = (Vector2) { gw->boundarie.x + gw->boundarie.width * spot, gw->boundarie.y + gw->boundarie.height / 2 };
+    gw->cueBall->pocketed = false;
+}
+
+void resetTurnStatistics( GameWorld *gw ) {
+
+    gw->statistics.cueBallHits = 0;
+    gw->statistics.cueBallFirstHitNumber = 0;
+    gw->statistics.cueBallPocketed = false;
+    gw->statistics.touchedCushion = 0;
+    gw->statistics.pocketed = 0;
+
+}
+
+// every game ends the same way so far
+static bool isGameOverByState( const GameWorld *gw ) {
+    return gw->state == GAME_STATE_GAME_OVER;
+}
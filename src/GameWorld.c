@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "raylib/raylib.h"
 #include "raylib/raymath.h"
@@ -18,14 +19,28 @@
 //#undef RAYGUI_IMPLEMENTATION     // raygui.h
 
 #include "Ball.h"
+#include "BallBatch.h"
+#include "BallMask.h"
+#include "BallMotion.h"
 #include "CommonMacros.h"
+#include "ComputerPlayer.h"
 #include "CueStick.h"
 #include "Cushion.h"
-#include "EBPRules.h"
+#include "Determinism.h"
+#include "GameRules.h"
 #include "GameWorld.h"
 #include "Pocket.h"
+#include "PositionTrace.h"
+#include "Replay.h"
 #include "ResourceManager.h"
+#include "SaveGame.h"
+#include "ShotPreview.h"
+#include "Simulation.h"
+#include "SimulationEvents.h"
+#include "SnookerRules.h"
+#include "Trajectory.h"
 #include "Types.h"
+#include "UndoHistory.h"
 
 static const Color BG_COLOR = { 28, 38, 58, 255 };
 static const Color TABLE_COLOR = { 135, 38, 8, 255 };
@@ -42,6 +57,48 @@ static float highlighCurrentPlayerCounter = 0.0f;
 static bool showHelp = SHOW_HELP;
 static bool bgMusicEnabled = BG_MUSIC_ENABLED;
 
+// plays for P2 when enabled
+static ComputerPlayer computerPlayer = { 0 };
+
+// the match being played is always recorded
+static const char *replayFileName = "replay.ebpr";
+static const char *saveFileName = "match.ebps";
+static Replay matchReplay = { 0 };
+static Vector2 dragStartPositions[BALL_CAPACITY];
+
+// replay mode: the live match waits in liveWorld
+static bool replaying = false;
+static Replay loadedReplay = { 0 };
+static ReplayPlayer replayPlayer = { 0 };
+static GameWorld liveWorld;
+static const int replaySpeeds[] = { 1, 2, 5, 10, 25, 50, REPLAY_MAX_SPEED };
+
+// slow motion of the last shot
+static PositionTrace shotTrace = { 0 };
+static bool watchingShotTrace = false;
+static PositionTraceView shotTraceView = { 0 };
+static const float shotTraceSpeeds[] = { 0.25f, 0.5f, 1.0f };
+
+// the table before each shot, for undo and redo
+static UndoHistory undoHistory = { 0 };
+
+static TrajectoryCache trajectoryCache = { 0 };
+
+// outcome of the aimed shot, asked for when the aim stays still for a while
+static ShotPreview shotPreview = { 0 };
+static uint32_t shotPreviewAim = 0;
+static float shotPreviewStillTime = 0.0f;
+static bool shotPreviewRequested = false;
+static const float shotPreviewDelay = 0.15f;
+
+// the shot in progress can be skipped to its end, a few thousand steps per
+// frame at most, or played faster drawing one of every N frames
+static bool fastForwarding = false;
+static const double fastForwardBudget = 0.008; // seconds of each frame
+static const int fastForwardChunk = 120;       // fixed steps between budget checks
+static const int shotSpeeds[] = { 1, 2, 4, 8 };
+static int shotSpeedIndex = 0;
+
 static const char *gameStateNames[] = { 
     "Breaking", 
     "Open Table", 
@@ -53,10 +110,31 @@ static const char *gameStateNames[] = {
 static void drawHud( GameWorld *gw );
 static void drawDebugInfo( GameWorld *gw );
 static void drawGameOver( GameWorld *gw );
-static void drawHelp( void );
+static void drawHelp( GameWorld *gw );
 static void drawTrajectory( GameWorld *gw );
 static void playBallHitSound( void );
 static void playBallCushionHitSound( void );
+static void playStepSounds( GameWorld *gw, uint32_t firstEvent );
+static bool isComputerTurn( GameWorld *gw );
+static void updateComputerTurn( GameWorld *gw, float delta );
+static void startMatch( GameWorld *gw, GameRulesType rulesType );
+static void startMatchReplay( GameWorld *gw );
+static void toggleReplayMode( GameWorld *gw );
+static void updateReplayMode( GameWorld *gw, float delta );
+static void drawReplayInfo( void );
+static void toggleShotTraceMode( GameWorld *gw );
+static void updateShotTraceMode( GameWorld *gw, float delta );
+static void drawShotTraceInfo( GameWorld *gw );
+static void moveInUndoHistory( GameWorld *gw, bool redo );
+static void loadSavedMatch( GameWorld *gw );
+static void updateGhostPreview( GameWorld *gw, float delta );
+static void drawGhostPreview( GameWorld *gw );
+static uint32_t aimChecksum( GameWorld *gw );
+static BallMask scoredBalls( GameWorld *gw, CueStick *cs );
+static void drawBallIcon( GameWorld *gw, int number, int x, int y, int radius );
+static void drawPoints( int points, Rectangle box );
+static SimulationStepReport advanceShot( GameWorld *gw, float delta );
+static void drawShotSpeedInfo( void );
 
 /**
  * @brief Creates a dinamically allocated GameWorld struct instance.
@@ -65,7 +143,18 @@ GameWorld* createGameWorld( void ) {
 
     GameWorld *gw = (GameWorld*) malloc( sizeof( GameWorld ) );
     
-    setupEBP( gw );
+    // resumes the match left when the window was closed
+    if ( loadGameWorld( gw, saveFileName ) ) {
+        startMatchReplay( gw );
+    } else {
+        seedRandom( &gw->rng, (uint64_t) time( NULL ) );
+        startMatch( gw, GAME_RULES_EIGHT_BALL );
+    }
+
+    setupPositionTrace( &shotTrace, POSITION_TRACE_SIZE, gw->clock.fixedDelta );
+    setupUndoHistory( &undoHistory, UNDO_HISTORY_CAPACITY );
+    setupShotPreview( &shotPreview );
+    setupComputerPlayer( &computerPlayer, COMPUTER_PLAYER_DIFFICULTY_MEDIUM );
     if ( BG_MUSIC_ENABLED ) {
         PlayMusicStream( rm.backgroundMusic );
     }
@@ -78,6 +167,19 @@ GameWorld* createGameWorld( void ) {
  * @brief Destroys a GameWindow object and its dependecies.
  */
 void destroyGameWorld( GameWorld *gw ) {
+    destroyComputerPlayer( &computerPlayer );
+    GameWorld *match = replaying ? &liveWorld : gw;
+    if ( getGameRules( match->rulesType )->isGameOver( match ) ) {
+        remove( saveFileName );
+    } else {
+        saveGameWorld( match, saveFileName );
+    }
+    saveReplay( &matchReplay, replayFileName );
+    destroyReplay( &matchReplay );
+    destroyReplay( &loadedReplay );
+    destroyPositionTrace( &shotTrace );
+    destroyUndoHistory( &undoHistory );
+    destroyShotPreview( &shotPreview );
     free( gw );
 }
 
@@ -98,11 +200,62 @@ void updateGameWorld( GameWorld *gw, float delta ) {
         return;
     }
 
-    if ( IsKeyPressed( KEY_R ) ) {
-        setupEBP( gw );
+    if ( IsKeyPressed( KEY_F3 ) ) {
+        toggleReplayMode( gw );
+    }
+
+    if ( replaying ) {
+        updateReplayMode( gw, delta );
+        return;
+    }
+
+    if ( IsKeyPressed( KEY_V ) ) {
+        toggleShotTraceMode( gw );
+    }
+
+    if ( watchingShotTrace ) {
+        updateShotTraceMode( gw, delta );
+        return;
+    }
+
+    // N restarts with the next game
+    if ( IsKeyPressed( KEY_R ) || IsKeyPressed( KEY_N ) ) {
+        GameRulesType rulesType = gw->rulesType;
+        if ( IsKeyPressed( KEY_N ) ) {
+            rulesType = ( rulesType + 1 ) % GAME_RULES_COUNT;
+        }
+        cancelComputerPlayerSearch( &computerPlayer );
+        clearPositionTrace( &shotTrace );
+        clearUndoHistory( &undoHistory );
+        saveReplay( &matchReplay, replayFileName );
+        startMatch( gw, rulesType );
+        return;
+    }
+
+    if ( IsKeyPressed( KEY_F5 ) ) {
+        saveGameWorld( gw, saveFileName );
+    }
+
+    if ( IsKeyPressed( KEY_F9 ) ) {
+        loadSavedMatch( gw );
         return;
     }
 
+    if ( IsKeyPressed( KEY_C ) ) {
+        cancelComputerPlayerSearch( &computerPlayer );
+        computerPlayer.enabled = !computerPlayer.enabled;
+    }
+
+    if ( IsKeyPressed( KEY_G ) ) {
+        shotPreview.enabled = !shotPreview.enabled;
+        shotPreviewAim = 0;
+        cancelShotPreview( &shotPreview );
+    }
+
+    if ( IsKeyPressed( KEY_D ) ) {
+        setComputerPlayerDifficulty( &computerPlayer, ( computerPlayer.difficulty + 1 ) % 3 );
+    }
+
     if ( IsKeyPressed( KEY_M ) ) {
         StopMusicStream( rm.backgroundMusic );
         bgMusicEnabled = !bgMusicEnabled;
@@ -112,22 +265,30 @@ void updateGameWorld( GameWorld *gw, float delta ) {
     }
 
     if ( IsKeyPressed( KEY_S ) ) {
-        for ( int i = 0; i <= BALL_COUNT; i++ ) {
+        for ( int i = 0; i < gw->ballCount; i++ ) {
             gw->balls[i].vel.x = 0;
             gw->balls[i].vel.y = 0;
         }
+        loadBallBatch( &gw->physics, gw->balls, gw->ballCount );
     }
 
-    // prev positions here (needed for cushion collision)
-    for ( int i = 0; i <= BALL_COUNT; i++ ) {
-        gw->balls[i].prevPos = gw->balls[i].center;
+    if ( gw->ballsState == GAME_STATE_BALLS_STOPPED && selectedBall == NULL ) {
+        if ( IsKeyPressed( KEY_Z ) ) {
+            moveInUndoHistory( gw, false );
+        } else if ( IsKeyPressed( KEY_Y ) ) {
+            moveInUndoHistory( gw, true );
+        }
     }
 
-    if ( gw->ballsState == GAME_STATE_BALLS_STOPPED ) {
+    if ( gw->ballsState == GAME_STATE_BALLS_STOPPED && isComputerTurn( gw ) ) {
+
+        updateComputerTurn( gw, delta );
+
+    } else if ( gw->ballsState == GAME_STATE_BALLS_STOPPED ) {
 
         if ( IsMouseButtonPressed( MOUSE_BUTTON_RIGHT ) ) {
             Vector2 mp = GetMousePosition();
-            for ( int i = 0; i <= BALL_COUNT; i++ ) {
+            for ( int i = 0; i < gw->ballCount; i++ ) {
                 Ball *b = &gw->balls[i];
                 if ( !b->pocketed && Vector2Distance( b->center, mp ) <= b->radius ) {
                     pressOffset = Vector2Subtract( mp, b->center );
@@ -135,15 +296,27 @@ void updateGameWorld( GameWorld *gw, float delta ) {
                     break;
                 }
             }
+            for ( int i = 0; i < gw->ballCount; i++ ) {
+                dragStartPositions[i] = gw->balls[i].center;
+            }
         } else if ( IsMouseButtonReleased( MOUSE_BUTTON_RIGHT ) ) {
             if ( selectedBall != NULL ) {
-                //
+                // the dragged ball and every ball it pushed
+                for ( int i = 0; i < gw->ballCount; i++ ) {
+                    Vector2 c = gw->balls[i].center;
+                    if ( c.x != dragStartPositions[i].x || c.y != dragStartPositions[i].y ) {
+                        recordReplayPlacement( &matchReplay, i, c );
+                        discardRedoHistory( &undoHistory );
+                    }
+                }
             }
             selectedBall = NULL;
         }
 
         if ( selectedBall != NULL ) {
             selectedBall->center = Vector2Subtract( GetMousePosition(), pressOffset );
+            selectedBall->moving = true; // wakes it up to push away the balls it overlaps
+            loadBallBatch( &gw->physics, gw->balls, gw->ballCount );
         }
 
         if ( IsMouseButtonPressed( MOUSE_BUTTON_LEFT ) ) {
@@ -151,221 +324,44 @@ void updateGameWorld( GameWorld *gw, float delta ) {
         }
 
         updateCueStick( gw->currentCueStick, delta );
-
-        if ( gw->currentCueStick->state == CUE_STICK_STATE_HIT ) {
-
-            if ( gw->currentCueStick->power != 0 ) {
-                PlaySound( rm.cueStickHitSound );
-            }
-
-            CueStick *cc = gw->currentCueStick;
-            gw->cueBall->vel.x = cc->power * cosf( DEG2RAD * cc->angle );
-            gw->cueBall->vel.y = cc->power * sinf( DEG2RAD * cc->angle );
-
-            // applies the spin based on the point of impact
-            gw->cueBall->spin.x = cc->hitPoint.x * 2.0f; // side spin
-            gw->cueBall->spin.y = cc->hitPoint.y * 2.0f; // top/back spin
-
-            cc->state = CUE_STICK_STATE_READY;
-            gw->applyRules = true;
-
-        }
+        updateGhostPreview( gw, delta );
 
     }
 
-    bool ballsMoving = false;
-
-    for ( int i = 0; i <= BALL_COUNT; i++ ) {
-
-        Ball *b = &gw->balls[i];
+    if ( gw->ballsState == GAME_STATE_BALLS_STOPPED && gw->currentCueStick->state == CUE_STICK_STATE_HIT ) {
 
-        if ( b->pocketed ) {
-            continue;
+        if ( gw->currentCueStick->power != 0 ) {
+            PlaySound( rm.cueStickHitSound );
         }
 
-        updateBall( b, delta );
-
-        // cushion collision
-        for ( int j = 0; j < 6; j++ ) {
-
-            Cushion *c = &gw->cushions[j];
-            CollisionResult collision = ballCushionCollision( b, c );
-
-            if ( collision.hasCollision ) {
-
-                playBallCushionHitSound();
-
-                // puts the ball in the exact point of contact
-                Vector2 movement = Vector2Subtract( b->center, b->prevPos );
-                b->center = Vector2Add( b->prevPos, Vector2Scale( movement, collision.t ) );
-
-                // calculates the reflection of the velocity
-                float dotProduct = Vector2DotProduct( b->vel, collision.normal );
-                b->vel = Vector2Subtract( b->vel, Vector2Scale( collision.normal, 2.0f * dotProduct ) ); 
-
-                // spin on reflection
-                if ( b == gw->cueBall && Vector2Length( b->spin ) > 0.01f ) {
-
-                    bool isVertical = fabs( collision.normal.x ) > fabs( collision.normal.y );
-
-                    if ( isVertical ) {
-                        // vertical cushion, spin.x affects angle
-                        float spinEffect = b->spin.x * 0.3f; // influence factor
-                        b->vel.y += spinEffect * fabs( b->vel.x );
-                    } else {
-                        // horizontal cushion, spin.y affects angle
-                        float spinEffect = b->spin.y * 0.3f; // influence factor
-                        b->vel.x += spinEffect * fabs( b->vel.y );
-                    }
-
-                    // decrease spin after collision
-                    b->spin = Vector2Scale( b->spin, 0.7f );
-
-                }
-
-                // applies elasticity
-                b->vel = Vector2Scale( b->vel, b->elasticity );
-
-                // apply some offset to prevent continuous collision
-                b->center = Vector2Add( b->center, Vector2Scale( collision.normal, 0.1f ) );
-
-                if ( gw->statistics.cueBallHits > 0 || gw->state != GAME_STATE_BREAKING ) {
-                    gw->statistics.ballsTouchedCushion[b->number] = true;
-                }
-
-            }
-
-        }
-
-        // ball x ball
-        for ( int j = 0; j <= BALL_COUNT; j++ ) {
-            if ( j != i ) {
-                Ball *bt = &gw->balls[j];
-                if ( bt->pocketed ) {
-                    continue;
-                }
-                if ( CheckCollisionCircles( b->center, b->radius, bt->center, bt->radius ) ) {
-                    if ( b == gw->cueBall ) {
-                        float speed = sqrtf( b->vel.x * b->vel.x + b->vel.y * b->vel.y );
-                        if ( speed > 400.0f ) { // 400 pixels/second
-                            PlaySound( rm.cueBallHitSound );
-                        } else {
-                            playBallHitSound();    
-                        }
-                    } else {
-                        playBallHitSound();
-                    }
-                    resolveCollisionBallBall( b, bt );
-                    if ( b == gw->cueBall ) {
-                        if ( gw->statistics.cueBallHits == 0 ) {
-                            gw->statistics.cueBallFirstHitNumber = bt->number;
-                        }
-                        gw->statistics.cueBallHits++;
-                    }
-                }
-            }
-        }
-
-        // ball x pockets
-        for ( int j = 0; j < 6; j++ ) {
-
-            float dist = Vector2Distance( b->center,  gw->pockets[j].center );
-
-            // more than 50% of ball is inside the pocket
-            if ( dist < gw->pockets[j].radius - b->radius * 0.5f ) {
-
-                PlaySound( rm.ballFallingSound );
-
-                b->pocketed = true;
-                b->vel = (Vector2) { 0 };
-                b->moving = false;
-
-                if ( b == gw->cueBall ) {
-                    gw->statistics.cueBallPocketed = true;
-                    resetCueBallPosition( gw );
-                } else {
-
-                    if ( gw->state != GAME_STATE_BREAKING ) {
-
-                        if ( gw->currentCueStick->group == BALL_GROUP_UNDEFINED ) {
-                            if ( gw->currentCueStick == &gw->cueStickP1 ) {
-                                gw->cueStickP1.pocketedBalls[gw->cueStickP1.pocketedCount++] = b->number;
-                            } else {
-                                gw->cueStickP2.pocketedBalls[gw->cueStickP2.pocketedCount++] = b->number;
-                            }
-                        } else if ( gw->currentCueStick->group == BALL_GROUP_SOLID ) {
-                            if ( gw->currentCueStick == &gw->cueStickP1 ) {
-                                if ( b->number < 8 ) {
-                                    gw->cueStickP1.pocketedBalls[gw->cueStickP1.pocketedCount++] = b->number;
-                                } else if ( b->number > 8 ) {
-                                    gw->cueStickP2.pocketedBalls[gw->cueStickP2.pocketedCount++] = b->number;
-                                }
-                            } else {
-                                if ( b->number < 8 ) {
-                                    gw->cueStickP2.pocketedBalls[gw->cueStickP2.pocketedCount++] = b->number;
-                                } else if ( b->number > 8 ) {
-                                    gw->cueStickP1.pocketedBalls[gw->cueStickP1.pocketedCount++] = b->number;
-                                }
-                            }
-                        } else if ( gw->currentCueStick->group == BALL_GROUP_STRIPED ) {
-                            if ( gw->currentCueStick == &gw->cueStickP1 ) {
-                                if ( b->number > 8 ) {
-                                    gw->cueStickP1.pocketedBalls[gw->cueStickP1.pocketedCount++] = b->number;
-                                } else if ( b->number < 8 ) {
-                                    gw->cueStickP2.pocketedBalls[gw->cueStickP2.pocketedCount++] = b->number;
-                                }
-                            } else {
-                                if ( b->number > 8 ) {
-                                    gw->cueStickP2.pocketedBalls[gw->cueStickP2.pocketedCount++] = b->number;
-                                } else if ( b->number < 8 ) {
-                                    gw->cueStickP1.pocketedBalls[gw->cueStickP1.pocketedCount++] = b->number;
-                                }
-                            }
-                        }
-
-                    }
-
-                    gw->statistics.pocketedBalls[gw->statistics.pocketedCount++] = b->number;
-                    gw->pocketedBalls[gw->pocketedCount++] = b->number;
-
-                }
-
-                break;
-
-            }
-
-        }
-
-        if ( !ballsMoving && b->moving ) {
-            ballsMoving = true;
-        }
+        pushUndoHistory( &undoHistory, gw, matchReplay.recordCount );
+        recordReplayShot( &matchReplay, gw );
+        cancelShotPreview( &shotPreview );
+        strikeCueBall( gw );
+        clearPositionTrace( &shotTrace );
+        recordPositionTrace( &shotTrace, gw );
 
     }
 
-    gw->currentCueStick->target = gw->cueBall->center;
-
-    if ( ballsMoving ) {
-        gw->ballsState = GAME_STATE_BALLS_MOVING;
-    } else {
-
-        gw->ballsState = GAME_STATE_BALLS_STOPPED;
-
-        if ( gw->applyRules ) {
-
-            gw->lastCueStick = gw->currentCueStick;
+    if ( IsKeyPressed( KEY_F ) && gw->applyRules ) {
+        fastForwarding = true;
+    }
 
-            if ( gw->currentCueStick == &gw->cueStickP1 ) {
-                gw->currentCueStick = &gw->cueStickP2;
-            } else {
-                gw->currentCueStick = &gw->cueStickP1;
-            }
+    if ( IsKeyPressed( KEY_TAB ) ) {
+        shotSpeedIndex = ( shotSpeedIndex + 1 ) % ( sizeof( shotSpeeds ) / sizeof( shotSpeeds[0] ) );
+    }
 
-            applyRulesEBP( gw );
+    SimulationStepReport report = advanceShot( gw, delta );
 
-            gw->applyRules = false;
+    if ( !report.ballsMoving ) {
+        fastForwarding = false;
+    }
 
+    if ( !report.ballsMoving && finishShot( gw ) ) {
+        recordReplayShotResult( &matchReplay, gw->checksum );
+        if ( getGameRules( gw->rulesType )->isGameOver( gw ) ) {
+            saveReplay( &matchReplay, replayFileName );
         }
-
     }
 
     highlighCurrentPlayerCounter += delta;
@@ -383,7 +379,8 @@ void drawGameWorld( GameWorld *gw ) {
     BeginDrawing();
     ClearBackground( BG_COLOR );
 
-    int pocketedBallsSupportWidth = BALL_RADIUS * 16 * 2;
+    // a slot for each object ball
+    int pocketedBallsSupportWidth = BALL_RADIUS * gw->ballCount * 2;
 
     DrawRectangleRounded( 
         (Rectangle) {
@@ -471,13 +468,27 @@ void drawGameWorld( GameWorld *gw ) {
         );
     }
 
-    DrawLine( 
-        gw->boundarie.x + gw->marksSpacing * 2, 
-        gw->boundarie.y,
-        gw->boundarie.x + gw->marksSpacing * 2, 
-        gw->boundarie.y + gw->boundarie.height,
-        WHITE
-    );
+    // the head string, or the baulk line and the D of snooker
+    if ( gw->rulesType == GAME_RULES_SNOOKER ) {
+        float baulk = snookerBaulkLine( gw );
+        DrawLine( baulk, gw->boundarie.y, baulk, gw->boundarie.y + gw->boundarie.height, WHITE );
+        DrawCircleSectorLines( 
+            (Vector2) { baulk, gw->boundarie.y + gw->boundarie.height / 2 },
+            snookerDRadius( gw ),
+            90,
+            270,
+            30,
+            WHITE
+        );
+    } else {
+        DrawLine( 
+            gw->boundarie.x + gw->marksSpacing * 2, 
+            gw->boundarie.y,
+            gw->boundarie.x + gw->marksSpacing * 2, 
+            gw->boundarie.y + gw->boundarie.height,
+            WHITE
+        );
+    }
 
     // pockets
     for ( int i = 0; i < 6; i++ ) {
@@ -489,27 +500,50 @@ void drawGameWorld( GameWorld *gw ) {
         drawCushion( &gw->cushions[i] );
     }
 
-    for ( int i = 0; i <= BALL_COUNT; i++ ) {
-        drawBall( &gw->balls[i] );
+    Vector2 tracePositions[BALL_CAPACITY];
+    bool traceVisible[BALL_CAPACITY];
+
+    if ( watchingShotTrace && samplePositionTrace( &shotTrace, shotTraceView.frame, tracePositions, traceVisible ) ) {
+        for ( int i = 0; i < gw->ballCount; i++ ) {
+            Ball b = gw->balls[i];
+            b.center = tracePositions[i];
+            b.pocketed = !traceVisible[i];
+            drawBall( &b );
+        }
+    } else {
+        for ( int i = 0; i < gw->ballCount; i++ ) {
+            drawBall( &gw->balls[i] );
+        }
     }
 
-    if ( gw->ballsState == GAME_STATE_BALLS_STOPPED && selectedBall == NULL ) {
+    if ( gw->ballsState == GAME_STATE_BALLS_STOPPED && selectedBall == NULL && !watchingShotTrace ) {
         drawCueStick( gw->currentCueStick );
     }
 
-    if ( gw->ballsState == GAME_STATE_BALLS_STOPPED && selectedBall == NULL ) {
+    if ( gw->ballsState == GAME_STATE_BALLS_STOPPED && selectedBall == NULL && !watchingShotTrace ) {
+        drawGhostPreview( gw );
         drawTrajectory( gw );
         drawCueStick( gw->currentCueStick );
     }
 
     drawHud( gw );
 
-    if ( gw->state == GAME_STATE_GAME_OVER ) {
+    if ( getGameRules( gw->rulesType )->isGameOver( gw ) ) {
         drawGameOver( gw );
     }
 
+    if ( replaying ) {
+        drawReplayInfo();
+    }
+
+    if ( watchingShotTrace ) {
+        drawShotTraceInfo( gw );
+    } else if ( !replaying && gw->applyRules ) {
+        drawShotSpeedInfo();
+    }
+
     if ( showHelp ) {
-        drawHelp();
+        drawHelp( gw );
     }
 
     if ( SHOW_DEBUG_INFO ) {
@@ -667,6 +701,7 @@ static void drawHud( GameWorld *gw ) {
     );
 
     DrawText( "P1", 15, 10, 20, RAYWHITE );
+    DrawText( getGameRules( gw->rulesType )->name, 5, 38, 10, RAYWHITE );
 
     DrawRectangleRounded( 
         (Rectangle) {
@@ -697,6 +732,16 @@ static void drawHud( GameWorld *gw ) {
 
     DrawText( "P2", GetScreenWidth() - 45 + 8, 10, 20, RAYWHITE );
 
+    if ( computerPlayer.enabled ) {
+        const char *cpuText = TextFormat( 
+            "CPU %s%s", 
+            getComputerPlayerDifficultyName( computerPlayer.difficulty ),
+            computerPlayer.search != NULL ? "..." : ""
+        );
+        int wCpuText = MeasureText( cpuText, 10 );
+        DrawText( cpuText, GetScreenWidth() - 5 - wCpuText, 38, 10, RAYWHITE );
+    }
+
     if ( gw->currentCueStick == &gw->cueStickP1 ) {
         DrawRectangleRoundedLines( 
             (Rectangle) {
@@ -723,60 +768,51 @@ static void drawHud( GameWorld *gw ) {
     int startScoreP1 = 65;
     int startScoreP2 = 642;
 
-    // TODO: refactor?
-    for ( int i = 0; i < 7; i++ ) {
-        int x = startScoreP1 + ( ( radius + 2 ) * 2 + spacing ) * i;
-        int y = 19;
-        DrawCircle( x, y, radius + 2, SCORE_POCKET_COLOR );
-        DrawCircleLines( x, y, radius + 2, GRAY );
-        if ( i < gw->cueStickP1.pocketedCount ) {
-            int number = gw->cueStickP1.pocketedBalls[i];
-            DrawTexturePro( 
-                rm.ballsTexture, 
-                (Rectangle) { 64 * number, 0, 64, 64 }, 
-                (Rectangle) { x - radius, y - radius, radius * 2, radius * 2 },
-                (Vector2) { 0 },
-                0.0f,
-                WHITE
-            );
+    int numbersP1[BALL_CAPACITY];
+    int numbersP2[BALL_CAPACITY];
+    int countP1 = ballMaskNumbers( scoredBalls( gw, &gw->cueStickP1 ), numbersP1 );
+    int countP2 = ballMaskNumbers( scoredBalls( gw, &gw->cueStickP2 ), numbersP2 );
+
+    // the games that count points show them instead of the balls
+    if ( gw->rulesType == GAME_RULES_SNOOKER ) {
+        int slotsWidth = ( ( radius + 2 ) * 2 + spacing ) * 7 - spacing;
+        drawPoints( gw->cueStickP1.score, (Rectangle) { startScoreP1 - radius - 2, 17 - radius, slotsWidth, ( radius + 2 ) * 2 } );
+        drawPoints( gw->cueStickP2.score, (Rectangle) { startScoreP2 - radius - 2, 17 - radius, slotsWidth, ( radius + 2 ) * 2 } );
+    } else {
+
+        // TODO: refactor?
+        for ( int i = 0; i < 7; i++ ) {
+            int x = startScoreP1 + ( ( radius + 2 ) * 2 + spacing ) * i;
+            int y = 19;
+            DrawCircle( x, y, radius + 2, SCORE_POCKET_COLOR );
+            DrawCircleLines( x, y, radius + 2, GRAY );
+            if ( i < countP1 ) {
+                drawBallIcon( gw, numbersP1[i], x, y, radius );
+            }
         }
-    }
-    
-    for ( int i = 0; i < 7; i++ ) {
-        int x = startScoreP2 + ( ( radius + 2 ) * 2 + spacing ) * i;
-        int y = 19;
-        DrawCircle( x, y, radius + 2, SCORE_POCKET_COLOR );
-        DrawCircleLines( x, y, radius + 2, GRAY );
-        if ( i < gw->cueStickP2.pocketedCount ) {
-            int number = gw->cueStickP2.pocketedBalls[i];
-            DrawTexturePro( 
-                rm.ballsTexture, 
-                (Rectangle) { 64 * number, 0, 64, 64 }, 
-                (Rectangle) { x - radius, y - radius, radius * 2, radius * 2 },
-                (Vector2) { 0 },
-                0.0f,
-                WHITE
-            );
+
+        for ( int i = 0; i < 7; i++ ) {
+            int x = startScoreP2 + ( ( radius + 2 ) * 2 + spacing ) * i;
+            int y = 19;
+            DrawCircle( x, y, radius + 2, SCORE_POCKET_COLOR );
+            DrawCircleLines( x, y, radius + 2, GRAY );
+            if ( i < countP2 ) {
+                drawBallIcon( gw, numbersP2[i], x, y, radius );
+            }
         }
+
     }
 
-    int startPocketed = GetScreenWidth() / 2 - radius * 14;
+    int slots = gw->ballCount - 1;
+    int startPocketed = GetScreenWidth() / 2 - radius * ( slots - 1 );
 
-    for ( int i = 0; i < 15; i++ ) {
+    for ( int i = 0; i < slots; i++ ) {
         int x = startPocketed + ( radius * 2 ) * i;
         int y = gw->boundarie.y + gw->boundarie.height + TABLE_MARGIN + radius * 2;
         DrawCircle( x, y, radius, ColorBrightness( TABLE_POCKETS_BALLS_SUPPORT_COLOR, -0.5f ) );
         DrawCircleLines( x, y, radius, BLACK );
         if ( i < gw->pocketedCount ) {
-            int number = gw->pocketedBalls[i];
-            DrawTexturePro( 
-                rm.ballsTexture, 
-                (Rectangle) { 64 * number, 0, 64, 64 }, 
-                (Rectangle) { x - radius, y - radius, radius * 2, radius * 2 },
-                (Vector2) { 0 },
-                0.0f,
-                WHITE
-            );
+            drawBallIcon( gw, gw->pocketedBalls[i], x, y, radius );
             DrawCircleLines( x, y, radius, BLACK );
         }
     }
@@ -826,22 +862,35 @@ static void drawDebugInfo( GameWorld *gw ) {
     DrawText( TextFormat( "cue x ball hits: %d", gw->statistics.cueBallHits ), 5, y + 5, 20, BLACK );
     DrawText( TextFormat( "cue first hit number: %d", gw->statistics.cueBallFirstHitNumber ), 5, y + 25, 20, BLACK );
     DrawText( TextFormat( "cue pocketed: %s", gw->statistics.cueBallPocketed ? "yes" : "no"  ), 5, y + 45, 20, BLACK );
-    DrawText( TextFormat( "balls touched cushion:", gw->statistics.pocketedCount ), 5, y + 65, 20, BLACK );
+    DrawText( "balls touched cushion:", 5, y + 65, 20, BLACK );
 
-    for ( int i = 0; i < 16; i++ ) {
-        DrawText( TextFormat( "%s", gw->statistics.ballsTouchedCushion[i] ? "y" : "n" ), 15 + 15 * i, y + 85, 20, BLACK );
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        DrawText( TextFormat( "%s", gw->statistics.touchedCushion & BALL_MASK( i ) ? "y" : "n" ), 15 + 15 * i, y + 85, 20, BLACK );
     }
 
-    DrawText( TextFormat( "balls pocketed: %d", gw->statistics.pocketedCount ), 5, y + 105, 20, BLACK );
+    int pocketed[BALL_CAPACITY];
+    int pocketedCount = ballMaskNumbers( gw->statistics.pocketed, pocketed );
+
+    DrawText( TextFormat( "balls pocketed: %d", pocketedCount ), 5, y + 105, 20, BLACK );
 
     int xStart = 15;
-    for ( int i = 0; i < gw->statistics.pocketedCount; i++ ) {
-        const char *t = TextFormat( "%d", gw->statistics.pocketedBalls[i] );
+    for ( int i = 0; i < pocketedCount; i++ ) {
+        const char *t = TextFormat( "%d", pocketed[i] );
         int w = MeasureText( t, 20 );
         DrawText( t, xStart, y + 125, 20, BLACK );
         xStart += w + 10;
     }
 
+    // friction only: contacts still to come may change it
+    float timeToRest = 0.0f;
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        if ( !gw->balls[i].pocketed && gw->balls[i].moving ) {
+            timeToRest = fmaxf( timeToRest, ballTimeToStop( &gw->balls[i] ) );
+        }
+    }
+    DrawText( TextFormat( "time to rest: %.2fs", timeToRest ), 5, y + 150, 20, BLACK );
+    DrawText( TextFormat( "events dropped: %u", gw->events.dropped ), 5, y + 172, 20, gw->events.dropped > 0 ? RED : BLACK );
+
     DrawText( TextFormat( "group: %d", gw->cueStickP1.group ), 20, 50, 20, WHITE );
     DrawText( TextFormat( "group: %d", gw->cueStickP2.group ), 800, 50, 20, WHITE );
 
@@ -923,12 +972,12 @@ static void drawGameOver( GameWorld *gw ) {
 
 }
 
-static void drawHelp( void ) {
+static void drawHelp( GameWorld *gw ) {
 
     DrawRectangle( 0, 0, GetScreenWidth(), GetScreenHeight(), Fade( BLACK, 0.85f ) );
 
     int boxWidth = 500;
-    int boxHeight = 510;
+    int boxHeight = 532;
     int boxX = GetScreenWidth() / 2 - boxWidth / 2;
     int boxY = GetScreenHeight() / 2 - boxHeight / 2;
 
@@ -998,28 +1047,32 @@ static void drawHelp( void ) {
     DrawText( "Move balls (free positioning)", leftMargin + 220, currentY, 14, GRAY );
     currentY += lineHeight;
 
-    DrawText( "Arrow Keys", leftMargin + 15, currentY, 14, RAYWHITE );
-    DrawText( "Adjust hit point (spin)", leftMargin + 220, currentY, 14, GRAY );
+    DrawText( "Arrow Keys / Space", leftMargin + 15, currentY, 14, RAYWHITE );
+    DrawText( "Adjust hit point (spin) / center it", leftMargin + 220, currentY, 14, GRAY );
+    currentY += lineHeight;
+
+    DrawText( "R / N / Z / Y", leftMargin + 15, currentY, 14, RAYWHITE );
+    DrawText( "Restart / next game (8, 9 ball, snooker) / undo / redo", leftMargin + 220, currentY, 14, GRAY );
     currentY += lineHeight;
 
-    DrawText( "Space", leftMargin + 15, currentY, 14, RAYWHITE );
-    DrawText( "Reset hit point to center", leftMargin + 220, currentY, 14, GRAY );
+    DrawText( "M / S", leftMargin + 15, currentY, 14, RAYWHITE );
+    DrawText( "Toggle music / stop all balls", leftMargin + 220, currentY, 14, GRAY );
     currentY += lineHeight;
 
-    DrawText( "R", leftMargin + 15, currentY, 14, RAYWHITE );
-    DrawText( "Restart game", leftMargin + 220, currentY, 14, GRAY );
+    DrawText( "V / G", leftMargin + 15, currentY, 14, RAYWHITE );
+    DrawText( "Last shot in slow motion / shot preview", leftMargin + 220, currentY, 14, GRAY );
     currentY += lineHeight;
 
-    DrawText( "M", leftMargin + 15, currentY, 14, RAYWHITE );
-    DrawText( "Toggle background music", leftMargin + 220, currentY, 14, GRAY );
+    DrawText( "C / D", leftMargin + 15, currentY, 14, RAYWHITE );
+    DrawText( "Toggle computer P2 / its difficulty", leftMargin + 220, currentY, 14, GRAY );
     currentY += lineHeight;
 
-    DrawText( "S", leftMargin + 15, currentY, 14, RAYWHITE );
-    DrawText( "Stop all balls immediately", leftMargin + 220, currentY, 14, GRAY );
+    DrawText( "F2 / F3", leftMargin + 15, currentY, 14, RAYWHITE );
+    DrawText( "Toggle this help screen / match replay", leftMargin + 220, currentY, 14, GRAY );
     currentY += lineHeight;
 
-    DrawText( "F2", leftMargin + 15, currentY, 14, RAYWHITE );
-    DrawText( "Toggle this help screen", leftMargin + 220, currentY, 14, GRAY );
+    DrawText( "F5 / F9", leftMargin + 15, currentY, 14, RAYWHITE );
+    DrawText( "Save / load the match", leftMargin + 220, currentY, 14, GRAY );
     currentY += lineHeight + 8;
 
     DrawLineEx( 
@@ -1031,26 +1084,41 @@ static void drawHelp( void ) {
 
     currentY += 12;
 
-    // Rules section
-    DrawText( "8 BALL POOL RULES:", leftMargin, currentY, 18, SKYBLUE );
-    currentY += lineHeight;
-
-    DrawText( "- First player to pocket all their balls (solid or striped) and then", leftMargin + 15, currentY, 13, RAYWHITE );
-    currentY += 18;
-    DrawText( "  legally pocket the 8-ball wins;", leftMargin + 15, currentY, 13, RAYWHITE );
-    currentY += 18;
+    // Rules section, of the game being played
+    const char *rules[] = {
+        "- First player to pocket all their balls (solid or striped) and then",
+        "  legally pocket the 8-ball wins;",
+        "- Groups are assigned after the break based on first ball pocketed;",
+        "- You must hit your group first, or it's a foul (ball in hand);",
+        "- Pocketing the 8-ball before clearing your group = instant loss;",
+        "- Continue playing if you pocket a ball legally."
+    };
 
-    DrawText( "- Groups are assigned after the break based on first ball pocketed;", leftMargin + 15, currentY, 13, RAYWHITE );
-    currentY += 18;
+    if ( gw->rulesType == GAME_RULES_NINE_BALL ) {
+        rules[0] = "- Only the balls 1 to 9 are racked, with the 1 at the apex and the 9";
+        rules[1] = "  in the middle;";
+        rules[2] = "- You must hit the lowest ball first, or it's a foul (ball in hand);";
+        rules[3] = "- Pocketing the 9-ball legally wins, even on the break;";
+        rules[4] = "- The 9-ball pocketed on a foul goes back to the foot spot;";
+        rules[5] = "- Continue playing if you pocket any ball legally.";
+    } else if ( gw->rulesType == GAME_RULES_SNOOKER ) {
+        rules[0] = "- Pot a red (1 point), then a colour (2 to 7), while reds are left;";
+        rules[1] = "- Then pot the colours in order, from the yellow to the black;";
+        rules[2] = "- Colours come back to their spots until the reds are gone;";
+        rules[3] = "- Hitting or potting a ball not on is a foul: 4 to 7 points to the";
+        rules[4] = "  opponent (a potted cue ball gives ball in hand);";
+        rules[5] = "- The highest score wins when the table is cleared.";
+    }
 
-    DrawText( "- You must hit your group first, or it's a foul (ball in hand);", leftMargin + 15, currentY, 13, RAYWHITE );
-    currentY += 18;
+    DrawText( TextFormat( "%s%s RULES:", TextToUpper( getGameRules( gw->rulesType )->name ), gw->rulesType == GAME_RULES_SNOOKER ? "" : " POOL" ), leftMargin, currentY, 18, SKYBLUE );
+    currentY += lineHeight;
 
-    DrawText( "- Pocketing the 8-ball before clearing your group = instant loss;", leftMargin + 15, currentY, 13, RAYWHITE );
-    currentY += 18;
+    for ( int i = 0; i < 6; i++ ) {
+        DrawText( rules[i], leftMargin + 15, currentY, 13, RAYWHITE );
+        currentY += 18;
+    }
 
-    DrawText( "- Continue playing if you pocket a ball legally.", leftMargin + 15, currentY, 13, RAYWHITE );
-    currentY += 22;
+    currentY += 4;
 
     DrawLineEx( 
         (Vector2) { boxX + 20, currentY }, 
@@ -1094,339 +1162,586 @@ static void drawHelp( void ) {
 
 }
 
-// calculate the predicted trajectory (better)
-static TrajectoryPrediction calculateTrajectory( GameWorld *gw ) {
+/**
+ * @brief Draws the predicted paths, from the cache: the prediction is only
+ * computed again when the aim, the power or the balls change.
+ */
+static void drawTrajectory( GameWorld *gw ) {
 
-    TrajectoryPrediction pred = { 0 };
+    const TrajectoryPrediction *pred = getCachedTrajectory( &trajectoryCache, gw );
+    const TrajectoryPath *cuePath = &pred->cueBallPath;
 
-    CueStick *cs = gw->currentCueStick;
+    // cue ball path, bounces included
+    for ( int i = 1; i < cuePath->pointCount; i++ ) {
+        DrawLineEx( 
+            cuePath->points[i-1], 
+            cuePath->points[i], 
+            2.0f, 
+            Fade( WHITE, pred->willHitBall ? 0.6f : 0.4f ) 
+        );
+    }
 
-    // shot direction
-    float angle = DEG2RAD * cs->angle;
-    Vector2 direction = { cosf( angle ), sinf( angle ) };
+    if ( !pred->willHitBall ) {
+        if ( cuePath->pocketed ) {
+            DrawCircleLinesV( pred->cueBallStopPoint, gw->cueBall->radius, Fade( RED, 0.6f ) );
+        }
+        return;
+    }
 
-    // starting point
-    Vector2 rayStart = gw->cueBall->center;
+    DrawTexturePro( 
+        rm.ballsTexture, 
+        (Rectangle) { 0, 0, 64, 64 }, 
+        (Rectangle) { pred->cueBallStopPoint.x - gw->cueBall->radius, pred->cueBallStopPoint.y - gw->cueBall->radius, gw->cueBall->radius * 2, gw->cueBall->radius * 2 },
+        (Vector2) { 0 },
+        0.0f,
+        Fade( WHITE, 0.3f ) 
+    );
 
-    // maximum ray distance (crosses the entire table)
-    float maxDistance = 2000.0f;
+    DrawCircleLines( 
+        pred->cueBallStopPoint.x, 
+        pred->cueBallStopPoint.y, 
+        gw->cueBall->radius, 
+        Fade( BLACK, 0.3f ) 
+    );
 
-    float closestDistance = maxDistance;
-    int closestBallIndex = -1;
-    Vector2 closestHitPoint = { 0 };
-    Vector2 closestCollisionPoint = { 0 };
+    // dashed line to indicate continuation
+    Vector2 lastStart = cuePath->points[cuePath->pointCount-2];
+    Vector2 dashDir = Vector2Normalize( Vector2Subtract( pred->cueBallStopPoint, lastStart ) );
+    float dashLength = 5.0f;
+    float gapLength = 5.0f;
+    float totalLength = 50.0f;
+
+    for ( float d = 0; d < totalLength; d += dashLength + gapLength ) {
+        Vector2 start = Vector2Add( pred->cueBallStopPoint, Vector2Scale( dashDir, d ) );
+        Vector2 end = Vector2Add( start, Vector2Scale( dashDir, dashLength ) );
+        DrawLineEx( start, end, 2.0f, Fade( WHITE, 0.4f ) );
+    }
 
-    // check collision with each ball
-    for ( int i = 1; i <= BALL_COUNT; i++ ) {
+    // impact point on target ball
+    Ball *targetBall = &gw->balls[pred->ballIndex];
 
-        Ball *b = &gw->balls[i];
+    // circle at contact point
+    DrawCircleV( pred->hitPoint, 4.0f, WHITE );
+    DrawCircleV( pred->hitPoint, 6.0f, Fade( WHITE, 0.3f ) );
 
-        if ( b->pocketed ) {
-            continue;
-        }
+    // highlight on ball that will be hit
+    DrawCircleLines( targetBall->center.x, targetBall->center.y, targetBall->radius + 3, Fade( WHITE, 0.5f ) );
+    DrawCircleLines( targetBall->center.x, targetBall->center.y, targetBall->radius + 5, Fade( WHITE, 0.3f ) );
 
-        // vector from cue ball center to target ball center
-        Vector2 toTarget = Vector2Subtract( b->center, rayStart );
+    // predicted trajectory of hit ball, bounces included
+    const TrajectoryPath *targetPath = &pred->targetBallPath;
 
-        // projection of vector onto ray direction
-        float projection = Vector2DotProduct( toTarget, direction );
+    if ( targetPath->pointCount < 2 ) {
+        return;
+    }
 
-        // if projection is negative, ball is behind
-        if ( projection <= 0 ) {
-            continue;
-        }
+    for ( int i = 1; i < targetPath->pointCount; i++ ) {
+        DrawLineEx( 
+            targetPath->points[i-1], 
+            targetPath->points[i], 
+            2.0f, 
+            Fade( WHITE, 0.5f ) 
+        );
+    }
 
-        // closest point on the ray to the ball center
-        Vector2 closestPointOnRay = Vector2Add( rayStart, Vector2Scale( direction, projection ) );
+    Vector2 targetEndPoint = targetPath->points[targetPath->pointCount-1];
+    Vector2 arrowDir = Vector2Subtract( targetEndPoint, targetPath->points[targetPath->pointCount-2] );
 
-        // distance from ball center to the ray
-        float distanceToRay = Vector2Distance( b->center, closestPointOnRay );
+    if ( targetPath->pocketed ) {
+        DrawCircleLinesV( targetEndPoint, targetBall->radius, Fade( GREEN, 0.8f ) );
+    } else if ( Vector2Length( arrowDir ) > 0.0f ) {
 
-        // sum of radii (collision threshold)
-        float sumRadii = gw->cueBall->radius + b->radius;
+        // arrow at the tip
+        float arrowSize = 8.0f;
+        arrowDir = Vector2Normalize( arrowDir );
+        Vector2 arrowPerp = { -arrowDir.y, arrowDir.x };
 
-        // if distance is less than sum of radii, there's a collision
-        if ( distanceToRay <= sumRadii ) {
+        Vector2 arrowTip = targetEndPoint;
+        Vector2 arrowLeft = Vector2Add( 
+            Vector2Add( arrowTip, Vector2Scale( arrowDir, -arrowSize ) ),
+            Vector2Scale( arrowPerp, arrowSize / 2 )
+        );
+        Vector2 arrowRight = Vector2Add( 
+            Vector2Add( arrowTip, Vector2Scale( arrowDir, -arrowSize ) ),
+            Vector2Scale( arrowPerp, -arrowSize / 2 )
+        );
 
-            // use Pythagorean theorem to find exact collision distance
-            // we need to find where the cue ball's edge first touches the target ball's edge
-            float distanceSquared = sumRadii * sumRadii - distanceToRay * distanceToRay;
+        DrawTriangle( arrowTip, arrowRight, arrowLeft, Fade( WHITE, 0.5f ) );
 
-            if ( distanceSquared < 0 ) {
-                distanceSquared = 0; // numerical safety
-            }
+    }
 
-            float offsetDistance = sqrtf( distanceSquared );
-            float collisionDistance = projection - offsetDistance;
+}
 
-            // only consider forward collisions
-            if ( collisionDistance > 0.01f && collisionDistance < closestDistance ) {
-                closestDistance = collisionDistance;
-                closestBallIndex = i;
+static void playBallHitSound( void ) {
+    PlaySound( rm.ballHitSounds[(rm.ballHitIndex++) % rm.ballHitCount] );
+}
 
-                // exact collision point (center of cue ball at moment of impact)
-                closestCollisionPoint = Vector2Add( rayStart, Vector2Scale( direction, collisionDistance ) );
+static void playBallCushionHitSound( void ) {
+    PlaySound( rm.ballCushionHitSounds[(rm.ballCushionHitIndex++) % rm.ballCushionHitCount] );
+}
 
-                // contact point on target ball surface
-                // this is the point where the two balls touch
-                Vector2 centerToCenterDir = Vector2Normalize( Vector2Subtract( b->center, closestCollisionPoint ) );
-                closestHitPoint = Vector2Subtract( b->center, Vector2Scale( centerToCenterDir, b->radius ) );
+/**
+ * @brief Plays the sounds of the events the physics pushed from firstEvent
+ * on, normally the ones of the frame.
+ */
+static void playStepSounds( GameWorld *gw, uint32_t firstEvent ) {
 
-            }
+    SimulationEvent e;
+    int cueBallIndex = gw->cueBall - gw->balls;
 
+    while ( readSimulationEvent( &gw->events, &firstEvent, &e ) ) {
+        switch ( e.type ) {
+            case SIMULATION_EVENT_BALL_HIT:
+                if ( e.a == cueBallIndex && e.value > 400.0f ) { // 400 pixels/second
+                    PlaySound( rm.cueBallHitSound );
+                } else {
+                    playBallHitSound();
+                }
+                break;
+            case SIMULATION_EVENT_CUSHION_HIT:
+                playBallCushionHitSound();
+                break;
+            case SIMULATION_EVENT_BALL_POCKETED:
+                PlaySound( rm.ballFallingSound );
+                break;
+            default:
+                break;
         }
+    }
+
+}
+
+static bool isComputerTurn( GameWorld *gw ) {
+    return computerPlayer.enabled &&
+           gw->currentCueStick == &gw->cueStickP2 &&
+           !getGameRules( gw->rulesType )->isGameOver( gw );
+}
+
+/**
+ * @brief Searches the shot in the background and, when it is ready, plays
+ * it with the same hit animation of a human player.
+ */
+static void updateComputerTurn( GameWorld *gw, float delta ) {
+
+    CueStick *cs = gw->currentCueStick;
 
+    if ( cs->state != CUE_STICK_STATE_READY ) {
+        updateCueStick( cs, delta );
+        return;
     }
 
-    if ( closestBallIndex != -1 ) {
+    ShotParams shot;
 
-        pred.willHitBall = true;
-        pred.ballIndex = closestBallIndex;
-        pred.hitPoint = closestHitPoint;
-        pred.cueBallStopPoint = closestCollisionPoint;
+    if ( computerPlayer.search == NULL ) {
+        startComputerPlayerSearch( &computerPlayer, gw );
+    } else if ( pollComputerPlayerSearch( &computerPlayer, &shot ) ) {
+        cs->angle = shot.angle;
+        cs->power = shot.power;
+        cs->hitPoint = shot.hitPoint;
+        cs->state = CUE_STICK_STATE_HITING;
+    }
 
-        // direction target ball will take
-        // this is the line from cue ball center to target ball center at impact
-        Ball *targetBall = &gw->balls[closestBallIndex];
-        Vector2 impactDirection = Vector2Normalize( 
-            Vector2Subtract( targetBall->center, closestCollisionPoint ) 
-        );
+}
 
-        pred.targetBallDirection = impactDirection;
+/**
+ * @brief Racks a new match of a game and starts recording it.
+ */
+static void startMatch( GameWorld *gw, GameRulesType rulesType ) {
+    uint64_t rackSeed = gw->rng.state;
+    setupGame( gw, rulesType );
+    destroyReplay( &matchReplay );
+    setupReplay( &matchReplay, rulesType, rackSeed, gw->clock.quality, REPLAY_KEYFRAME_INTERVAL );
+}
 
-        // estimated speed (based on power)
-        float powerPercent = getCueStickPowerPercentage( cs );
-        pred.targetBallSpeed = powerPercent * 300.0f; // adjust as needed
+/**
+ * @brief Starts recording the match of the world, racked from the current
+ * state of the random number generator.
+ */
+static void startMatchReplay( GameWorld *gw ) {
+    destroyReplay( &matchReplay );
+    setupReplay( &matchReplay, gw->rulesType, gw->rng.state, gw->clock.quality, REPLAY_KEYFRAME_INTERVAL );
+}
 
-    } else {
+/**
+ * @brief Enters the replay of the match (saved and loaded back, so it is
+ * the same path a replay file of another match takes) or goes back to the
+ * live match.
+ */
+static void toggleReplayMode( GameWorld *gw ) {
 
-        // won't hit any ball, trajectory goes to the end
-        pred.willHitBall = false;
-        pred.cueBallStopPoint = Vector2Add( rayStart, Vector2Scale( direction, maxDistance ) );
+    if ( replaying ) {
+        cloneGameWorld( gw, &liveWorld );
+        destroyReplay( &loadedReplay );
+        replaying = false;
+        return;
+    }
 
+    if ( gw->ballsState != GAME_STATE_BALLS_STOPPED ||
+         !saveReplay( &matchReplay, replayFileName ) ||
+         !loadReplay( &loadedReplay, replayFileName ) ) {
+        return;
     }
 
-    return pred;
+    cancelComputerPlayerSearch( &computerPlayer );
+    selectedBall = NULL;
+    watchingShotTrace = false;
+    cloneGameWorld( &liveWorld, gw );
+    setupReplayPlayer( &replayPlayer, &loadedReplay, gw );
+    replaying = true;
 
 }
 
-// calculate the predicted trajectory
-__attribute__((unused)) static TrajectoryPrediction calculateTrajectoryOld( GameWorld *gw ) {
+/**
+ * @brief Left and right seek the previous and next shots, up and down
+ * change the speed and space pauses.
+ */
+static void updateReplayMode( GameWorld *gw, float delta ) {
+
+    int current = replayPlayer.nextShot;
 
-    TrajectoryPrediction pred = { 0 };
+    if ( gw->ballsState == GAME_STATE_BALLS_MOVING ) {
+        current--;
+    }
 
-    CueStick *cs = gw->currentCueStick;
+    if ( IsKeyPressed( KEY_LEFT ) ) {
+        seekReplayPlayer( &replayPlayer, gw, current - 1 );
+    } else if ( IsKeyPressed( KEY_RIGHT ) ) {
+        seekReplayPlayer( &replayPlayer, gw, current + 1 );
+    }
+
+    int speedCount = sizeof( replaySpeeds ) / sizeof( replaySpeeds[0] );
+    int speedIndex = 0;
+
+    while ( speedIndex < speedCount - 1 && replaySpeeds[speedIndex] < replayPlayer.speed ) {
+        speedIndex++;
+    }
 
-    // shot direction
-    float angle = DEG2RAD * cs->angle;
-    Vector2 direction = { cosf( angle ), sinf( angle ) };
+    if ( IsKeyPressed( KEY_UP ) && speedIndex < speedCount - 1 ) {
+        replayPlayer.speed = replaySpeeds[speedIndex + 1];
+    } else if ( IsKeyPressed( KEY_DOWN ) && speedIndex > 0 ) {
+        replayPlayer.speed = replaySpeeds[speedIndex - 1];
+    }
 
-    // starting point
-    Vector2 rayStart = gw->cueBall->center;
+    if ( IsKeyPressed( KEY_SPACE ) ) {
+        replayPlayer.paused = !replayPlayer.paused;
+    }
 
-    // maximum ray distance (crosses the entire table)
-    float maxDistance = 2000.0f;
+    uint32_t firstEvent = gw->events.written;
+    updateReplayPlayer( &replayPlayer, gw, delta );
+    playStepSounds( gw, firstEvent );
 
-    float closestDistance = maxDistance;
-    int closestBallIndex = -1;
-    Vector2 closestHitPoint = { 0 };
+}
 
-    // check collision with each ball
-    for ( int i = 1; i <= BALL_COUNT; i++ ) {
+static void drawReplayInfo( void ) {
 
-        Ball *b = &gw->balls[i];
+    const char *text = TextFormat( 
+        "REPLAY - shot %d/%d - %dx%s - Left/Right: seek, Up/Down: speed, Space: pause, F3: back to the match",
+        replayPlayer.nextShot,
+        replayPlayer.replay->shotCount,
+        replayPlayer.speed,
+        replayPlayer.paused ? " (paused)" : ""
+    );
 
-        if ( b->pocketed ) {
-            continue;
+    int w = MeasureText( text, 10 );
+    DrawRectangle( GetScreenWidth() / 2 - w / 2 - 5, GetScreenHeight() - 18, w + 10, 16, Fade( BLACK, 0.6f ) );
+    DrawText( text, GetScreenWidth() / 2 - w / 2, GetScreenHeight() - 15, 10, GOLD );
+
+}
+
+/**
+ * @brief Undoes or redoes a shot, cutting the match replay to the shots
+ * still played, or growing it back.
+ */
+static void moveInUndoHistory( GameWorld *gw, bool redo ) {
+
+    int replayLength = matchReplay.recordCount;
+    bool moved = redo ?
+        redoGameWorld( &undoHistory, gw, &replayLength ) :
+        undoGameWorld( &undoHistory, gw, &replayLength );
+
+    if ( moved ) {
+        cancelComputerPlayerSearch( &computerPlayer );
+        setReplayLength( &matchReplay, replayLength );
+        clearPositionTrace( &shotTrace );
+    }
+
+}
+
+/**
+ * @brief Goes back to the match saved with F5 (or when the window was
+ * closed). The replay of the current match is saved and a new one starts
+ * from the loaded table.
+ */
+static void loadSavedMatch( GameWorld *gw ) {
+
+    cancelComputerPlayerSearch( &computerPlayer );
+
+    if ( !loadGameWorld( gw, saveFileName ) ) {
+        return;
+    }
+
+    selectedBall = NULL;
+    clearPositionTrace( &shotTrace );
+    clearUndoHistory( &undoHistory );
+    saveReplay( &matchReplay, replayFileName );
+    startMatchReplay( gw );
+
+}
+
+/**
+ * @brief Asks the worker for the outcome of the aimed shot once the aim,
+ * the power and the balls stayed the same for shotPreviewDelay seconds. Any
+ * change drops the request in progress and hides the ghosts.
+ */
+static void updateGhostPreview( GameWorld *gw, float delta ) {
+
+    if ( !shotPreview.enabled ) {
+        return;
+    }
+
+    uint32_t aim = aimChecksum( gw );
+
+    if ( aim != shotPreviewAim || selectedBall != NULL ) {
+        shotPreviewAim = aim;
+        shotPreviewStillTime = 0.0f;
+        shotPreviewRequested = false;
+        cancelShotPreview( &shotPreview );
+    } else {
+        shotPreviewStillTime += delta;
+        if ( !shotPreviewRequested && shotPreviewStillTime >= shotPreviewDelay ) {
+            requestShotPreview( &shotPreview, gw );
+            shotPreviewRequested = true;
         }
+    }
+
+    updateShotPreview( &shotPreview );
+
+}
+
+/**
+ * @brief Ghosts where the moved balls come to rest and rings on the balls
+ * that drop.
+ */
+static void drawGhostPreview( GameWorld *gw ) {
+
+    // the result of another aim or table is never shown
+    if ( !shotPreview.enabled || !shotPreview.hasResult || shotPreviewAim != aimChecksum( gw ) ) {
+        return;
+    }
 
-        // vector from cue ball center to target ball center
-        Vector2 toTarget = Vector2Subtract( b->center, rayStart );
+    ShotPreviewResult *r = &shotPreview.result;
 
-        // projection of vector onto ray
-        float projection = Vector2DotProduct( toTarget, direction );
+    for ( int i = 0; i < gw->ballCount; i++ ) {
 
-        // if projection is negative, ball is behind
-        if ( projection < 0 ) {
+        Ball *b = &gw->balls[i];
+
+        if ( b->pocketed ) {
             continue;
         }
 
-        // closest point on ray
-        Vector2 closestPoint = Vector2Add( rayStart, Vector2Scale( direction, projection ) );
-
-        // distance from ball center to closest point
-        float distanceToRay = Vector2Distance( b->center, closestPoint );
+        if ( r->pocketed[i] ) {
+            DrawCircleLinesV( b->center, b->radius + 3, i == 0 ? RED : GREEN );
+            DrawCircleLinesV( b->center, b->radius + 4, Fade( i == 0 ? RED : GREEN, 0.5f ) );
+        } else if ( Vector2Distance( b->center, r->positions[i] ) > 1.0f ) {
+            drawBallAt( b, r->positions[i], b->radius, Fade( WHITE, 0.35f ) );
+            DrawCircleLinesV( r->positions[i], b->radius, Fade( BLACK, 0.35f ) );
+        }
 
-        // sum of radii
-        float sumRadii = gw->cueBall->radius + b->radius;
+    }
 
-        // if distance is less than sum of radii, there's a collision
-        if ( distanceToRay < sumRadii ) {
+}
 
-            // calculate distance to collision point
-            float offsetDistance = sqrtf( sumRadii * sumRadii - distanceToRay * distanceToRay );
-            float collisionDistance = projection - offsetDistance;
+/**
+ * @brief Changes whenever the shot would: the cue stick angle, power and hit
+ * point and the ball layout.
+ */
+static uint32_t aimChecksum( GameWorld *gw ) {
 
-            if ( collisionDistance > 0 && collisionDistance < closestDistance ) {
+    CueStick *cs = gw->currentCueStick;
+    uint32_t hash = CHECKSUM_START;
 
-                closestDistance = collisionDistance;
-                closestBallIndex = i;
+    hash = checksumBytes( hash, &cs->angle, sizeof( cs->angle ) );
+    hash = checksumBytes( hash, &cs->power, sizeof( cs->power ) );
+    hash = checksumBytes( hash, &cs->hitPoint, sizeof( cs->hitPoint ) );
+    hash = checksumBytes( hash, &gw->currentCueStick, sizeof( gw->currentCueStick ) );
 
-                // collision point
-                Vector2 collisionPoint = Vector2Add( rayStart, Vector2Scale( direction, collisionDistance ) );
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        hash = checksumBytes( hash, &gw->balls[i].center, sizeof( gw->balls[i].center ) );
+        hash = checksumBytes( hash, &gw->balls[i].pocketed, sizeof( gw->balls[i].pocketed ) );
+    }
 
-                // contact point on target ball surface
-                Vector2 toBall = Vector2Normalize( Vector2Subtract( b->center, collisionPoint ) );
-                closestHitPoint = Vector2Add( b->center, Vector2Scale( toBall, -b->radius ) );
+    return hash;
 
-            }
+}
 
-        }
+/**
+ * @brief Watches the last shot again from the position trace, or goes back
+ * to the match. The world itself is not touched.
+ */
+static void toggleShotTraceMode( GameWorld *gw ) {
 
+    if ( watchingShotTrace ) {
+        watchingShotTrace = false;
+        return;
     }
 
-    if ( closestBallIndex != -1 ) {
+    if ( gw->ballsState != GAME_STATE_BALLS_STOPPED || shotTrace.count == 0 ) {
+        return;
+    }
 
-        pred.willHitBall = true;
-        pred.ballIndex = closestBallIndex;
-        pred.hitPoint = closestHitPoint;
+    selectedBall = NULL;
+    setupPositionTraceView( &shotTraceView, shotTraceSpeeds[0] );
+    watchingShotTrace = true;
 
-        // point where cue ball stops (approximate)
-        pred.cueBallStopPoint = Vector2Add( rayStart, Vector2Scale( direction, closestDistance ) );
+}
 
-        // direction target ball will take
-        Ball *targetBall = &gw->balls[closestBallIndex];
-        Vector2 impactDirection = Vector2Normalize( 
-            Vector2Subtract( targetBall->center, pred.cueBallStopPoint ) 
-        );
+/**
+ * @brief Up and down change the speed, space pauses (or restarts at the
+ * end) and dragging with the left button scrubs along the table width.
+ */
+static void updateShotTraceMode( GameWorld *gw, float delta ) {
 
-        pred.targetBallDirection = impactDirection;
+    int speedCount = sizeof( shotTraceSpeeds ) / sizeof( shotTraceSpeeds[0] );
+    int speedIndex = 0;
 
-        // estimated speed (based on power)
-        float powerPercent = getCueStickPowerPercentage( cs );
-        pred.targetBallSpeed = powerPercent * 300.0f; // todo: adjust if needed
+    while ( speedIndex < speedCount - 1 && shotTraceSpeeds[speedIndex] < shotTraceView.speed ) {
+        speedIndex++;
+    }
 
-    } else {
+    if ( IsKeyPressed( KEY_UP ) && speedIndex < speedCount - 1 ) {
+        shotTraceView.speed = shotTraceSpeeds[speedIndex + 1];
+    } else if ( IsKeyPressed( KEY_DOWN ) && speedIndex > 0 ) {
+        shotTraceView.speed = shotTraceSpeeds[speedIndex - 1];
+    }
 
-        // won't hit any ball, trajectory goes to the end
-        pred.willHitBall = false;
-        pred.cueBallStopPoint = Vector2Add( rayStart, Vector2Scale( direction, maxDistance ) );
+    if ( IsKeyPressed( KEY_SPACE ) ) {
+        if ( shotTraceView.frame >= shotTrace.count - 1 ) {
+            shotTraceView.frame = 0.0f;
+            shotTraceView.paused = false;
+        } else {
+            shotTraceView.paused = !shotTraceView.paused;
+        }
+    }
 
+    if ( IsMouseButtonDown( MOUSE_BUTTON_LEFT ) ) {
+        float t = ( GetMouseX() - gw->boundarie.x ) / gw->boundarie.width;
+        shotTraceView.frame = Clamp( t, 0.0f, 1.0f ) * ( shotTrace.count - 1 );
+        shotTraceView.paused = true;
     }
 
-    return pred;
+    updatePositionTraceView( &shotTraceView, &shotTrace, delta );
 
 }
 
-// draw the predicted trajectory
-static void drawTrajectory( GameWorld *gw ) {
+static void drawShotTraceInfo( GameWorld *gw ) {
 
-    //TrajectoryPrediction pred = calculateTrajectoryOld( gw );
-    TrajectoryPrediction pred = calculateTrajectory( gw );
-    Vector2 rayStart = gw->cueBall->center;
+    float progress = shotTrace.count > 1 ? shotTraceView.frame / ( shotTrace.count - 1 ) : 1.0f;
 
-    if ( pred.willHitBall ) {
+    DrawRectangle( gw->boundarie.x, gw->boundarie.y + gw->boundarie.height - 4, gw->boundarie.width, 4, Fade( BLACK, 0.6f ) );
+    DrawRectangle( gw->boundarie.x, gw->boundarie.y + gw->boundarie.height - 4, gw->boundarie.width * progress, 4, GOLD );
 
-        DrawTexturePro( 
-            rm.ballsTexture, 
-            (Rectangle) { 0, 0, 64, 64 }, 
-            (Rectangle) { pred.cueBallStopPoint.x - gw->cueBall->radius, pred.cueBallStopPoint.y - gw->cueBall->radius, gw->cueBall->radius * 2, gw->cueBall->radius * 2 },
-            (Vector2) { 0 },
-            0.0f,
-            Fade( WHITE, 0.3f ) 
-        );
+    const char *text = TextFormat( 
+        "LAST SHOT - %.2fs/%.2fs - %.2fx%s - Up/Down: speed, Space: pause, Left Drag: scrub, V: back to the match",
+        shotTraceView.frame * shotTrace.stepDelta,
+        ( shotTrace.count - 1 ) * shotTrace.stepDelta,
+        shotTraceView.speed,
+        shotTraceView.paused ? " (paused)" : ""
+    );
 
-        DrawCircleLines( 
-            pred.cueBallStopPoint.x, 
-            pred.cueBallStopPoint.y, 
-            gw->cueBall->radius, 
-            Fade( BLACK, 0.3f ) 
-        );
+    int w = MeasureText( text, 10 );
+    DrawRectangle( GetScreenWidth() / 2 - w / 2 - 5, GetScreenHeight() - 18, w + 10, 16, Fade( BLACK, 0.6f ) );
+    DrawText( text, GetScreenWidth() / 2 - w / 2, GetScreenHeight() - 15, 10, GOLD );
 
-        // line from cue ball to impact point
-        DrawLineEx( 
-            rayStart, 
-            pred.cueBallStopPoint, 
-            2.0f, 
-            Fade( WHITE, 0.6f ) 
-        );
+}
+
+/**
+ * @brief Advances the balls for a frame of delta seconds: as much of the
+ * shot as fits in the time budget when skipping to its end, or as many
+ * frames as the shot speed otherwise. The result is the same at any speed,
+ * only the number of frames drawn changes. Skipped steps play no sounds.
+ */
+static SimulationStepReport advanceShot( GameWorld *gw, float delta ) {
+
+    // only the steps of a shot are traced, not the ones pushing dragged balls
+    PositionTrace *trace = gw->applyRules ? &shotTrace : NULL;
+    SimulationStepReport report;
 
-        // dashed line to indicate continuation
-        Vector2 direction = Vector2Normalize( Vector2Subtract( pred.cueBallStopPoint, rayStart ) );
-        Vector2 extendedPoint = Vector2Add( pred.cueBallStopPoint, Vector2Scale( direction, 50.0f ) );
+    if ( fastForwarding && gw->applyRules ) {
 
-        // draw dashed line
-        float dashLength = 5.0f;
-        float gapLength = 5.0f;
-        Vector2 dashDir = Vector2Normalize( Vector2Subtract( extendedPoint, pred.cueBallStopPoint ) );
-        float totalLength = Vector2Distance( pred.cueBallStopPoint, extendedPoint );
+        double start = GetTime();
+        report = fastForwardSimulation( gw, fastForwardChunk, trace );
 
-        for ( float d = 0; d < totalLength; d += dashLength + gapLength ) {
-            Vector2 start = Vector2Add( pred.cueBallStopPoint, Vector2Scale( dashDir, d ) );
-            Vector2 end = Vector2Add( start, Vector2Scale( dashDir, dashLength ) );
-            DrawLineEx( start, end, 2.0f, Fade( WHITE, 0.4f ) );
+        while ( report.ballsMoving && GetTime() - start < fastForwardBudget ) {
+            SimulationStepReport chunk = fastForwardSimulation( gw, fastForwardChunk, trace );
+            mergeStepReport( &report, &chunk );
         }
 
-        // impact point on target ball
-        Ball *targetBall = &gw->balls[pred.ballIndex];
+        return report;
 
-        // circle at contact point
-        DrawCircleV( pred.hitPoint, 4.0f, WHITE );
-        DrawCircleV( pred.hitPoint, 6.0f, Fade( WHITE, 0.3f ) );
+    }
 
-        // highlight on ball that will be hit
-        DrawCircleLines( targetBall->center.x, targetBall->center.y, targetBall->radius + 3, Fade( WHITE, 0.5f ) );
-        DrawCircleLines( targetBall->center.x, targetBall->center.y, targetBall->radius + 5, Fade( WHITE, 0.3f ) );
+    int speed = gw->applyRules ? shotSpeeds[shotSpeedIndex] : 1;
+    uint32_t firstEvent = gw->events.written;
+    report = advanceSimulation( gw, delta, trace );
 
-        // predicted trajectory of hit ball
-        Vector2 targetEndPoint = Vector2Add( 
-            targetBall->center, 
-            Vector2Scale( pred.targetBallDirection, pred.targetBallSpeed ) 
-        );
+    for ( int i = 1; i < speed; i++ ) {
+        SimulationStepReport frame = advanceSimulation( gw, delta, trace );
+        mergeStepReport( &report, &frame );
+    }
 
-        // target ball trajectory line
-        DrawLineEx( 
-            targetBall->center, 
-            targetEndPoint, 
-            2.0f, 
-            Fade( WHITE, 0.5f ) 
-        );
+    playStepSounds( gw, firstEvent );
 
-        // arrow at the tip
-        float arrowSize = 8.0f;
-        Vector2 arrowDir = Vector2Normalize( pred.targetBallDirection );
-        Vector2 arrowPerp = { -arrowDir.y, arrowDir.x };
+    return report;
 
-        Vector2 arrowTip = targetEndPoint;
-        Vector2 arrowLeft = Vector2Add( 
-            Vector2Add( arrowTip, Vector2Scale( arrowDir, -arrowSize ) ),
-            Vector2Scale( arrowPerp, arrowSize / 2 )
-        );
-        Vector2 arrowRight = Vector2Add( 
-            Vector2Add( arrowTip, Vector2Scale( arrowDir, -arrowSize ) ),
-            Vector2Scale( arrowPerp, -arrowSize / 2 )
-        );
+}
 
-        DrawTriangle( arrowTip, arrowRight, arrowLeft, Fade( WHITE, 0.5f ) );
+static void drawShotSpeedInfo( void ) {
 
-    } else {
+    const char *text = fastForwarding ?
+        "SHOT - skipping to the end" :
+        TextFormat( "SHOT - %dx - F: skip to the end, Tab: speed", shotSpeeds[shotSpeedIndex] );
 
-        // won't hit any ball, just draw the line
-        DrawLineEx( 
-            rayStart, 
-            pred.cueBallStopPoint, 
-            2.0f, 
-            Fade( WHITE, 0.4f ) 
-        );
+    int w = MeasureText( text, 10 );
+    DrawRectangle( GetScreenWidth() / 2 - w / 2 - 5, GetScreenHeight() - 18, w + 10, 16, Fade( BLACK, 0.6f ) );
+    DrawText( text, GetScreenWidth() / 2 - w / 2, GetScreenHeight() - 15, 10, GOLD );
 
+}
+
+/**
+ * @brief The balls shown in the score of a player: the ones of their group
+ * already off the table, whoever pocketed them, or the ones they pocketed
+ * while the table was open.
+ */
+static BallMask scoredBalls( GameWorld *gw, CueStick *cs ) {
+
+    if ( cs->group == BALL_GROUP_UNDEFINED ) {
+        return cs->pocketed;
     }
 
+    return groupBallMask( cs->group ) & ~tableBallMask( gw->balls, gw->ballCount );
+
 }
 
-static void playBallHitSound( void ) {
-    PlaySound( rm.ballHitSounds[(rm.ballHitIndex++) % rm.ballHitCount] );
+/**
+ * @brief A ball of the HUD, drawn like the ball with the number on the
+ * table.
+ */
+static void drawBallIcon( GameWorld *gw, int number, int x, int y, int radius ) {
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        if ( gw->balls[i].number == number ) {
+            drawBallAt( &gw->balls[i], (Vector2) { x, y }, radius, WHITE );
+            return;
+        }
+    }
 }
 
-static void playBallCushionHitSound( void ) {
-    PlaySound( rm.ballCushionHitSounds[(rm.ballCushionHitIndex++) % rm.ballCushionHitCount] );
+static void drawPoints( int points, Rectangle box ) {
+
+    const char *text = TextFormat( "%d", points );
+    int w = MeasureText( text, 20 );
+
+    DrawRectangleRounded( box, 0.5f, 10, SCORE_POCKET_COLOR );
+    DrawRectangleRoundedLines( box, 0.5f, 10, GRAY );
+    DrawText( text, box.x + box.width / 2 - w / 2, box.y + box.height / 2 - 10, 20, RAYWHITE );
+
 }
@@ -0,0 +1,217 @@
+/**
+ * @file NineBallRules.c
+ * @author Prof. Dr. David Buzatto
+ * @brief 9 Ball Pool rules implementation.
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+
+#include "BallMask.h"
+#include "CommonMacros.h"
+#include "Determinism.h"
+#include "GameRules.h"
+#include "NineBallRules.h"
+#include "Types.h"
+
+#define BALL_9_MASK BALL_MASK( 9 )
+
+static bool isValidBreak( GameWorld *gw );
+static bool isFault( GameWorld *gw );
+static void spotBall9( GameWorld *gw );
+static void rackNineBall( GameWorld *gw );
+
+void applyRulesNineBall( GameWorld *gw ) {
+
+    trace( "applying rules:" );
+
+    if ( gw->state == GAME_STATE_BREAKING ) {
+
+        trace( "  state: breaking" );
+
+        if ( !isValidBreak( gw ) ) {
+            trace( "    invalid break = resetting" );
+            setupNineBall( gw );
+            return;
+        }
+
+        trace( "    ok - valid break" );
+
+    }
+
+    if ( isFault( gw ) ) {
+        if ( gw->statistics.pocketed & BALL_9_MASK ) {
+            trace( "    ball 9 pocketed on a fault - spotted again" );
+            spotBall9( gw );
+        }
+        gw->state = GAME_STATE_BALL_IN_HAND;
+        trace( "    -> ball in hand" );
+        return;
+    }
+
+    if ( gw->statistics.pocketed & BALL_9_MASK ) {
+        trace( "    ball 9 pocketed legally - player wins!" );
+        gw->winnerCueStick = gw->lastCueStick;
+        gw->state = GAME_STATE_GAME_OVER;
+        return;
+    }
+
+    if ( gw->statistics.pocketed != 0 ) {
+        gw->currentCueStick = gw->lastCueStick;
+        trace( "    pocketed balls - turn continues" );
+    } else {
+        trace( "    no pocketed balls - turn ends" );
+    }
+
+    gw->state = GAME_STATE_PLAYING;
+
+}
+
+// any ball pocketed goes to the shooter, even on the break
+void onEventNineBall( GameWorld *gw, const SimulationEvent *event ) {
+    if ( event->type == SIMULATION_EVENT_BALL_POCKETED && &gw->balls[event->a] != gw->cueBall ) {
+        gw->currentCueStick->pocketed |= BALL_MASK( gw->balls[event->a].number );
+    }
+}
+
+BallMask legalTargetsNineBall( const GameWorld *gw ) {
+    return lowestBallMask( tableBallMask( gw->balls, gw->ballCount ) & ~CUE_BALL_MASK );
+}
+
+static bool isValidBreak( GameWorld *gw ) {
+    return gw->statistics.cueBallHits > 0 &&
+           !gw->statistics.cueBallPocketed &&
+           ( countBallMask( gw->statistics.touchedCushion ) >= 4 || gw->statistics.pocketed != 0 );
+}
+
+static bool isFault( GameWorld *gw ) {
+
+    if ( gw->statistics.cueBallHits == 0 ) {
+        trace( "    fault: didn't hit anything" );
+        return true;
+    }
+
+    if ( gw->statistics.cueBallPocketed ) {
+        trace( "    fault: cue ball pocketed" );
+        return true;
+    }
+
+    // the lowest ball when the shot started, it may be pocketed by now
+    BallMask target = lowestBallMask( ( tableBallMask( gw->balls, gw->ballCount ) | gw->statistics.pocketed ) & ~CUE_BALL_MASK );
+
+    if ( BALL_MASK( gw->statistics.cueBallFirstHitNumber ) != target ) {
+        trace( "    fault: didn't hit the lowest ball first" );
+        return true;
+    }
+
+    if ( gw->statistics.touchedCushion == 0 && gw->statistics.pocketed == 0 ) {
+        trace( "    fault: neither cushion hit nor pocketed ball" );
+        return true;
+    }
+
+    return false;
+
+}
+
+// back on the foot spot, or behind it towards the foot cushion when a ball
+// is in the way
+static void spotBall9( GameWorld *gw ) {
+
+    Ball *ball9 = NULL;
+
+    for ( int i = 1; i < gw->ballCount; i++ ) {
+        if ( gw->balls[i].number == 9 ) {
+            ball9 = &gw->balls[i];
+        }
+    }
+
+    Vector2 spot = footSpot( gw );
+    bool free = false;
+
+    while ( !free ) {
+        free = true;
+        for ( int i = 0; i < gw->ballCount; i++ ) {
+            Ball *b = &gw->balls[i];
+            if ( b != ball9 && !b->pocketed && Vector2Distance( b->center, spot ) < b->radius + ball9->radius ) {
+                spot.x += b->radius + ball9->radius;
+                free = false;
+                break;
+            }
+        }
+    }
+
+    ball9->center = spot;
+    ball9->prevPos = spot;
+    ball9->vel = (Vector2) { 0, 0 };
+    ball9->spin = (Vector2) { 0, 0 };
+    ball9->moving = false;
+    ball9->pocketed = false;
+
+    gw->lastCueStick->pocketed &= (BallMask) ~BALL_9_MASK;
+
+    // off the rail of the pocketed balls
+    int count = 0;
+    for ( int i = 0; i < gw->pocketedCount; i++ ) {
+        if ( gw->pocketedBalls[i] != 9 ) {
+            gw->pocketedBalls[count++] = gw->pocketedBalls[i];
+        }
+    }
+    gw->pocketedCount = count;
+
+}
+
+void setupNineBall( GameWorld *gw ) {
+
+    setupTable( gw, GAME_RULES_NINE_BALL );
+
+    // the balls 10 to 15 are not played
+    for ( int i = 10; i < gw->ballCount; i++ ) {
+        gw->balls[i].pocketed = true;
+    }
+
+    rackNineBall( gw );
+
+}
+
+// a diamond with the 1 at the apex, the 9 in the middle and the others
+// anywhere
+static void rackNineBall( GameWorld *gw ) {
+
+    int numbers[] = { 1, 2, 3, 4, 9, 5, 6, 7, 8 };
+    int others[] = { 1, 2, 3, 5, 6, 7, 8 };
+    int rowSizes[] = { 1, 2, 3, 2, 1 };
+
+    if ( SHUFFLE_BALLS ) {
+        for ( int i = 0; i < 7; i++ ) {
+            int p = nextRandomValue( &gw->rng, 0, 6 );
+            int n = numbers[others[i]];
+            numbers[others[i]] = numbers[others[p]];
+            numbers[others[p]] = n;
+        }
+    }
+
+    Vector2 spot = footSpot( gw );
+    float radius = gw->cueBall->radius;
+    int k = 1;
+
+    for ( int i = 0; i < 5; i++ ) {
+        float iniY = spot.y - radius * ( rowSizes[i] - 1 );
+        for ( int j = 0; j < rowSizes[i]; j++ ) {
+            Ball *b = &gw->balls[k];
+            b->number = numbers[k-1];
+            b->color = ballColor( b->number );
+            b->striped = b->number > 8;
+            b->center = (Vector2) {
+                spot.x + ( radius * 2 ) * i - 2.5f * i,
+                iniY + ( radius * 2 ) * j + 0.5f * j
+            };
+            b->prevPos = b->center;
+            k++;
+        }
+    }
+
+}
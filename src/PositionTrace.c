@@ -0,0 +1,175 @@
+/**
+ * @file PositionTrace.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Position trace implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "raylib/raylib.h"
+
+#include "CommonMacros.h"
+#include "PositionTrace.h"
+#include "Types.h"
+
+static int16_t quantize( float v );
+static float dequantize( int16_t v );
+
+void setupPositionTrace( PositionTrace *pt, int size, float stepDelta ) {
+    pt->coordinates = (int16_t*) malloc( sizeof( int16_t ) * size );
+    pt->size = pt->coordinates != NULL ? size : 0;
+    pt->ballCount = 0;
+    pt->capacity = 0;
+    pt->first = 0;
+    pt->count = 0;
+    pt->stepDelta = stepDelta;
+}
+
+void destroyPositionTrace( PositionTrace *pt ) {
+    free( pt->coordinates );
+    pt->coordinates = NULL;
+    pt->size = 0;
+    pt->ballCount = 0;
+    pt->capacity = 0;
+    pt->first = 0;
+    pt->count = 0;
+}
+
+void clearPositionTrace( PositionTrace *pt ) {
+    pt->first = 0;
+    pt->count = 0;
+}
+
+void recordPositionTrace( PositionTrace *pt, const GameWorld *gw ) {
+
+    if ( pt == NULL || pt->size == 0 ) {
+        return;
+    }
+
+    // the frames are as wide as the balls of the game, so a game with
+    // another ball count starts the ring again
+    if ( pt->ballCount != gw->ballCount ) {
+        pt->ballCount = gw->ballCount;
+        pt->capacity = pt->size / ( gw->ballCount * 2 );
+        pt->first = 0;
+        pt->count = 0;
+    }
+
+    int index;
+
+    if ( pt->count < pt->capacity ) {
+        index = ( pt->first + pt->count ) % pt->capacity;
+        pt->count++;
+    } else {
+        index = pt->first;
+        pt->first = ( pt->first + 1 ) % pt->capacity;
+    }
+
+    int16_t *f = &pt->coordinates[index * pt->ballCount * 2];
+
+    // taken between steps, from the physics state
+    const BallBatch *bb = &gw->physics;
+
+    for ( int i = 0; i < pt->ballCount; i++ ) {
+        if ( bb->pocketed[i] ) {
+            f[i * 2] = POSITION_TRACE_OFF_TABLE;
+            f[i * 2 + 1] = POSITION_TRACE_OFF_TABLE;
+        } else {
+            f[i * 2] = quantize( bb->x[i] );
+            f[i * 2 + 1] = quantize( bb->y[i] );
+        }
+    }
+
+}
+
+bool samplePositionTrace( const PositionTrace *pt, float frame, Vector2 *positions, bool *visible ) {
+
+    if ( pt->count == 0 ) {
+        return false;
+    }
+
+    if ( frame < 0.0f ) {
+        frame = 0.0f;
+    } else if ( frame > pt->count - 1 ) {
+        frame = pt->count - 1;
+    }
+
+    int i0 = (int) frame;
+    int i1 = i0 + 1 < pt->count ? i0 + 1 : i0;
+    float t = frame - i0;
+
+    const int16_t *f0 = &pt->coordinates[( pt->first + i0 ) % pt->capacity * pt->ballCount * 2];
+    const int16_t *f1 = &pt->coordinates[( pt->first + i1 ) % pt->capacity * pt->ballCount * 2];
+
+    for ( int i = 0; i < pt->ballCount; i++ ) {
+
+        visible[i] = f0[i * 2] != POSITION_TRACE_OFF_TABLE;
+
+        if ( !visible[i] ) {
+            continue;
+        }
+
+        Vector2 p0 = { dequantize( f0[i * 2] ), dequantize( f0[i * 2 + 1] ) };
+
+        // a ball pocketed in the next frame stays where it was
+        if ( f1[i * 2] == POSITION_TRACE_OFF_TABLE ) {
+            positions[i] = p0;
+        } else {
+            positions[i] = (Vector2) {
+                p0.x + ( dequantize( f1[i * 2] ) - p0.x ) * t,
+                p0.y + ( dequantize( f1[i * 2 + 1] ) - p0.y ) * t
+            };
+        }
+
+    }
+
+    return true;
+
+}
+
+void setupPositionTraceView( PositionTraceView *view, float speed ) {
+    view->frame = 0.0f;
+    view->speed = speed;
+    view->paused = false;
+}
+
+bool updatePositionTraceView( PositionTraceView *view, const PositionTrace *pt, float delta ) {
+
+    float last = pt->count > 0 ? pt->count - 1 : 0;
+
+    if ( !view->paused && pt->stepDelta > 0.0f ) {
+        view->frame += delta * view->speed / pt->stepDelta;
+    }
+
+    if ( view->frame >= last ) {
+        view->frame = last;
+        return false;
+    }
+
+    return true;
+
+}
+
+static int16_t quantize( float v ) {
+
+    float q = roundf( v * POSITION_TRACE_SCALE );
+
+    // INT16_MIN is kept for the pocketed balls
+    if ( q < INT16_MIN + 1 ) {
+        q = INT16_MIN + 1;
+    } else if ( q > INT16_MAX ) {
+        q = INT16_MAX;
+    }
+
+    return (int16_t) q;
+
+}
+
+static float dequantize( int16_t v ) {
+    return v / POSITION_TRACE_SCALE;
+}
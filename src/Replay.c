@@ -0,0 +1,591 @@
+/**
+ * @file Replay.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Match replay implementation.
+ *
+ * File layout (little endian):
+ *   "EBPR", version (u16), keyframe interval (u16), physics quality (u8),
+ *   game rules (u8), rack seed (u64), shot count (u32), record count (u32), records,
+ *   keyframe count (u32), keyframes (the seek index).
+ * A shot record takes 21 bytes, a placement 10 and a keyframe about 300.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "raylib/raylib.h"
+
+#include "BallBatch.h"
+#include "BinaryIO.h"
+#include "CommonMacros.h"
+#include "GameRules.h"
+#include "Replay.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "Types.h"
+
+// pause between two shots on playback, in seconds of replay time
+#define REPLAY_SHOT_PAUSE 0.75f
+
+static ReplayRecord *addRecord( Replay *replay );
+static void playRecordHeadless( GameWorld *gw, const ReplayRecord *record );
+static void applyPlacement( GameWorld *gw, const ReplayRecord *record );
+static void strikeRecordedShot( GameWorld *gw, const ReplayRecord *record );
+static void writeSnapshot( FILE *file, const GameSnapshot *s );
+static bool readSnapshot( FILE *file, GameSnapshot *s );
+
+void setupReplay( Replay *replay, GameRulesType rulesType, uint64_t rackSeed, SimulationQuality quality, int keyframeInterval ) {
+    replay->rulesType = rulesType;
+    replay->rackSeed = rackSeed;
+    replay->quality = quality;
+    replay->keyframeInterval = keyframeInterval;
+    replay->shotCount = 0;
+    replay->records = NULL;
+    replay->recordCount = 0;
+    replay->recordCapacity = 0;
+    replay->keyframes = NULL;
+    replay->keyframeCount = 0;
+    replay->keyframeCapacity = 0;
+}
+
+void destroyReplay( Replay *replay ) {
+    free( replay->records );
+    free( replay->keyframes );
+    setupReplay( replay, replay->rulesType, replay->rackSeed, replay->quality, replay->keyframeInterval );
+}
+
+void recordReplayShot( Replay *replay, const GameWorld *gw ) {
+
+    if ( replay->shotCount % replay->keyframeInterval == 0 ) {
+
+        if ( replay->keyframeCount == replay->keyframeCapacity ) {
+            int capacity = replay->keyframeCapacity == 0 ? 8 : replay->keyframeCapacity * 2;
+            ReplayKeyframe *keyframes = (ReplayKeyframe*) realloc( replay->keyframes, sizeof( ReplayKeyframe ) * capacity );
+            if ( keyframes == NULL ) {
+                return;
+            }
+            replay->keyframes = keyframes;
+            replay->keyframeCapacity = capacity;
+        }
+
+        ReplayKeyframe *k = &replay->keyframes[replay->keyframeCount++];
+        k->shot = replay->shotCount;
+        k->record = replay->recordCount;
+        captureGameSnapshot( &k->snapshot, gw );
+
+    }
+
+    ReplayRecord *r = addRecord( replay );
+
+    if ( r != NULL ) {
+        CueStick *cs = gw->currentCueStick;
+        r->type = REPLAY_RECORD_SHOT;
+        r->shot = (ShotParams) {
+            .angle = cs->angle,
+            .power = cs->power,
+            .hitPoint = cs->hitPoint
+        };
+        r->checksum = 0;
+        replay->shotCount++;
+    }
+
+}
+
+void recordReplayShotResult( Replay *replay, uint32_t checksum ) {
+    for ( int i = replay->recordCount - 1; i >= 0; i-- ) {
+        if ( replay->records[i].type == REPLAY_RECORD_SHOT ) {
+            replay->records[i].checksum = checksum;
+            return;
+        }
+    }
+}
+
+void recordReplayPlacement( Replay *replay, int ball, Vector2 position ) {
+
+    ReplayRecord *r = addRecord( replay );
+
+    if ( r != NULL ) {
+        r->type = REPLAY_RECORD_PLACEMENT;
+        r->ball = ball;
+        r->position = position;
+    }
+
+}
+
+void setReplayLength( Replay *replay, int recordCount ) {
+
+    if ( recordCount < 0 || recordCount > replay->recordCapacity ) {
+        return;
+    }
+
+    replay->recordCount = recordCount;
+    replay->shotCount = 0;
+
+    for ( int i = 0; i < recordCount; i++ ) {
+        if ( replay->records[i].type == REPLAY_RECORD_SHOT ) {
+            replay->shotCount++;
+        }
+    }
+
+    // a keyframe was taken before every keyframeInterval shots
+    int keyframeCount = ( replay->shotCount + replay->keyframeInterval - 1 ) / replay->keyframeInterval;
+    replay->keyframeCount = keyframeCount < replay->keyframeCapacity ? keyframeCount : replay->keyframeCapacity;
+
+}
+
+bool saveReplay( const Replay *replay, const char *path ) {
+
+    FILE *file = fopen( path, "wb" );
+
+    if ( file == NULL ) {
+        return false;
+    }
+
+    writeUint8( file, 'E' );
+    writeUint8( file, 'B' );
+    writeUint8( file, 'P' );
+    writeUint8( file, 'R' );
+    writeUint16( file, REPLAY_VERSION );
+    writeUint16( file, (uint16_t) replay->keyframeInterval );
+    writeUint8( file, (uint8_t) replay->quality );
+    writeUint8( file, (uint8_t) replay->rulesType );
+    writeUint64( file, replay->rackSeed );
+    writeUint32( file, (uint32_t) replay->shotCount );
+    writeUint32( file, (uint32_t) replay->recordCount );
+
+    for ( int i = 0; i < replay->recordCount; i++ ) {
+        ReplayRecord *r = &replay->records[i];
+        writeUint8( file, (uint8_t) r->type );
+        if ( r->type == REPLAY_RECORD_SHOT ) {
+            writeFloat( file, r->shot.angle );
+            writeInt32( file, r->shot.power );
+            writeFloat( file, r->shot.hitPoint.x );
+            writeFloat( file, r->shot.hitPoint.y );
+            writeUint32( file, r->checksum );
+        } else {
+            writeUint8( file, (uint8_t) r->ball );
+            writeFloat( file, r->position.x );
+            writeFloat( file, r->position.y );
+        }
+    }
+
+    writeUint32( file, (uint32_t) replay->keyframeCount );
+
+    for ( int i = 0; i < replay->keyframeCount; i++ ) {
+        writeUint32( file, (uint32_t) replay->keyframes[i].shot );
+        writeUint32( file, (uint32_t) replay->keyframes[i].record );
+        writeSnapshot( file, &replay->keyframes[i].snapshot );
+    }
+
+    bool ok = !ferror( file );
+
+    return fclose( file ) == 0 && ok;
+
+}
+
+bool loadReplay( Replay *replay, const char *path ) {
+
+    setupReplay( replay, GAME_RULES_EIGHT_BALL, 0, PHYSICS_QUALITY, REPLAY_KEYFRAME_INTERVAL );
+
+    FILE *file = fopen( path, "rb" );
+
+    if ( file == NULL ) {
+        return false;
+    }
+
+    uint8_t magic[4];
+    uint16_t version;
+    uint16_t interval;
+    uint8_t quality;
+    uint8_t rulesType;
+    uint32_t shotCount;
+    uint32_t recordCount;
+    uint32_t keyframeCount;
+    bool ok = true;
+
+    for ( int i = 0; i < 4; i++ ) {
+        ok = ok && readUint8( file, &magic[i] );
+    }
+
+    ok = ok && magic[0] == 'E' && magic[1] == 'B' && magic[2] == 'P' && magic[3] == 'R';
+    ok = ok && readUint16( file, &version ) && version == REPLAY_VERSION;
+    ok = ok && readUint16( file, &interval ) && interval > 0;
+    ok = ok && readUint8( file, &quality ) && quality <= SIMULATION_QUALITY_HIGH;
+    replay->quality = (SimulationQuality) quality;
+    ok = ok && readUint8( file, &rulesType ) && rulesType < GAME_RULES_COUNT;
+    replay->rulesType = (GameRulesType) rulesType;
+    ok = ok && readUint64( file, &replay->rackSeed );
+    ok = ok && readUint32( file, &shotCount );
+    ok = ok && readUint32( file, &recordCount );
+
+    for ( uint32_t i = 0; ok && i < recordCount; i++ ) {
+
+        ReplayRecord *r = addRecord( replay );
+        uint8_t type;
+        uint8_t ball;
+
+        ok = r != NULL && readUint8( file, &type );
+
+        if ( ok && type == REPLAY_RECORD_SHOT ) {
+            r->type = REPLAY_RECORD_SHOT;
+            ok = readFloat( file, &r->shot.angle ) &&
+                 readInt32( file, &r->shot.power ) &&
+                 readFloat( file, &r->shot.hitPoint.x ) &&
+                 readFloat( file, &r->shot.hitPoint.y ) &&
+                 readUint32( file, &r->checksum );
+        } else if ( ok && type == REPLAY_RECORD_PLACEMENT ) {
+            r->type = REPLAY_RECORD_PLACEMENT;
+            ok = readUint8( file, &ball ) &&
+                 readFloat( file, &r->position.x ) &&
+                 readFloat( file, &r->position.y ) &&
+                 ball < BALL_CAPACITY;
+            r->ball = ball;
+        } else {
+            ok = false;
+        }
+
+    }
+
+    ok = ok && readUint32( file, &keyframeCount );
+
+    if ( ok && keyframeCount > 0 ) {
+        replay->keyframes = (ReplayKeyframe*) malloc( sizeof( ReplayKeyframe ) * keyframeCount );
+        replay->keyframeCapacity = keyframeCount;
+        ok = replay->keyframes != NULL;
+    }
+
+    for ( uint32_t i = 0; ok && i < keyframeCount; i++ ) {
+        ReplayKeyframe *k = &replay->keyframes[i];
+        uint32_t shot;
+        uint32_t record;
+        ok = readUint32( file, &shot ) &&
+             readUint32( file, &record ) &&
+             readSnapshot( file, &k->snapshot ) &&
+             shot <= shotCount && record <= recordCount &&
+             k->snapshot.ballCount == getGameRules( replay->rulesType )->layout.ballCount;
+        k->shot = shot;
+        k->record = record;
+        replay->keyframeCount++;
+    }
+
+    fclose( file );
+
+    if ( !ok ) {
+        destroyReplay( replay );
+        return false;
+    }
+
+    replay->keyframeInterval = interval;
+    replay->shotCount = shotCount;
+
+    return true;
+
+}
+
+int seekReplay( const Replay *replay, GameWorld *gw, int shot ) {
+
+    gw->rng.state = replay->rackSeed;
+    setupGame( gw, replay->rulesType );
+
+    // the steps adapt differently on each preset, so the match is played on its own
+    setupSimulationClock( &gw->clock, PHYSICS_FRAME_RATE, replay->quality, PHYSICS_MAX_STEPS_PER_FRAME );
+
+    int record = 0;
+    int played = 0;
+
+    // the last keyframe at or before the shot, racked for the same game
+    ReplayKeyframe *keyframe = NULL;
+
+    for ( int i = 0; i < replay->keyframeCount && replay->keyframes[i].shot <= shot; i++ ) {
+        if ( replay->keyframes[i].snapshot.ballCount == gw->ballCount ) {
+            keyframe = &replay->keyframes[i];
+        }
+    }
+
+    if ( keyframe != NULL ) {
+        restoreGameSnapshot( gw, &keyframe->snapshot );
+        record = keyframe->record;
+        played = keyframe->shot;
+    }
+
+    // up to the shot record itself, placements before it included
+    while ( record < replay->recordCount ) {
+        const ReplayRecord *r = &replay->records[record];
+        if ( r->type == REPLAY_RECORD_SHOT ) {
+            if ( played == shot ) {
+                break;
+            }
+            played++;
+        }
+        playRecordHeadless( gw, r );
+        record++;
+    }
+
+    return record;
+
+}
+
+int verifyReplay( const Replay *replay, GameWorld *gw ) {
+
+    // the first keyframe, if any, is the table of a resumed match
+    int shot = 0;
+
+    for ( int i = seekReplay( replay, gw, 0 ); i < replay->recordCount; i++ ) {
+        const ReplayRecord *r = &replay->records[i];
+        playRecordHeadless( gw, r );
+        if ( r->type == REPLAY_RECORD_SHOT ) {
+            if ( gw->checksum != r->checksum ) {
+                return shot;
+            }
+            shot++;
+        }
+    }
+
+    return -1;
+
+}
+
+void setupReplayPlayer( ReplayPlayer *rp, Replay *replay, GameWorld *gw ) {
+    rp->replay = replay;
+    rp->speed = 1;
+    rp->paused = false;
+    seekReplayPlayer( rp, gw, 0 );
+}
+
+void seekReplayPlayer( ReplayPlayer *rp, GameWorld *gw, int shot ) {
+
+    if ( shot < 0 ) {
+        shot = 0;
+    } else if ( shot > rp->replay->shotCount ) {
+        shot = rp->replay->shotCount;
+    }
+
+    rp->nextRecord = seekReplay( rp->replay, gw, shot );
+    rp->nextShot = shot;
+    rp->wait = REPLAY_SHOT_PAUSE;
+
+}
+
+SimulationStepReport updateReplayPlayer( ReplayPlayer *rp, GameWorld *gw, float delta ) {
+
+    SimulationStepReport total = { 0 };
+    total.ballsMoving = gw->ballsState == GAME_STATE_BALLS_MOVING;
+
+    if ( rp->paused ) {
+        return total;
+    }
+
+    // the speed runs whole frames again, so the step limit of the clock holds
+    for ( int i = 0; i < rp->speed; i++ ) {
+
+        if ( gw->ballsState == GAME_STATE_BALLS_STOPPED ) {
+
+            rp->wait -= delta;
+
+            if ( rp->wait > 0.0f || rp->nextRecord >= rp->replay->recordCount ) {
+                continue;
+            }
+
+            // placements, then the next shot
+            while ( rp->nextRecord < rp->replay->recordCount ) {
+                const ReplayRecord *r = &rp->replay->records[rp->nextRecord++];
+                if ( r->type == REPLAY_RECORD_PLACEMENT ) {
+                    applyPlacement( gw, r );
+                } else {
+                    strikeRecordedShot( gw, r );
+                    rp->nextShot++;
+                    break;
+                }
+            }
+
+        }
+
+        SimulationStepReport step = advanceSimulation( gw, delta, NULL );
+        mergeStepReport( &total, &step );
+
+        if ( !step.ballsMoving && finishShot( gw ) ) {
+            rp->wait = REPLAY_SHOT_PAUSE;
+        }
+
+    }
+
+    return total;
+
+}
+
+static ReplayRecord *addRecord( Replay *replay ) {
+
+    if ( replay->recordCount == replay->recordCapacity ) {
+        int capacity = replay->recordCapacity == 0 ? 64 : replay->recordCapacity * 2;
+        ReplayRecord *records = (ReplayRecord*) realloc( replay->records, sizeof( ReplayRecord ) * capacity );
+        if ( records == NULL ) {
+            return NULL;
+        }
+        replay->records = records;
+        replay->recordCapacity = capacity;
+    }
+
+    return &replay->records[replay->recordCount++];
+
+}
+
+static void playRecordHeadless( GameWorld *gw, const ReplayRecord *record ) {
+
+    if ( record->type == REPLAY_RECORD_PLACEMENT ) {
+        applyPlacement( gw, record );
+        return;
+    }
+
+    strikeRecordedShot( gw, record );
+
+    int steps = 0;
+    SimulationStepReport report;
+
+    do {
+        report = simulateNextStep( gw );
+        steps++;
+    } while ( report.ballsMoving && steps < SIMULATION_MAX_SHOT_STEPS );
+
+    finishShot( gw );
+
+}
+
+// the ball wakes up, so one step pockets it if it was dropped on a pocket
+static void applyPlacement( GameWorld *gw, const ReplayRecord *record ) {
+    Ball *b = &gw->balls[record->ball];
+    b->center = record->position;
+    b->moving = true;
+    loadBallBatch( &gw->physics, gw->balls, gw->ballCount );
+    simulateNextStep( gw );
+}
+
+static void strikeRecordedShot( GameWorld *gw, const ReplayRecord *record ) {
+    CueStick *cs = gw->currentCueStick;
+    cs->angle = record->shot.angle;
+    cs->power = record->shot.power;
+    cs->hitPoint = record->shot.hitPoint;
+    strikeCueBall( gw );
+}
+
+static void writeSnapshot( FILE *file, const GameSnapshot *s ) {
+
+    uint32_t pocketed = 0;
+
+    writeUint8( file, (uint8_t) s->ballCount );
+
+    for ( int i = 0; i < s->ballCount; i++ ) {
+        writeFloat( file, s->centers[i].x );
+        writeFloat( file, s->centers[i].y );
+        writeUint8( file, (uint8_t) s->numbers[i] );
+        writeUint8( file, s->striped[i] );
+        writeUint8( file, s->colors[i].r );
+        writeUint8( file, s->colors[i].g );
+        writeUint8( file, s->colors[i].b );
+        writeUint8( file, s->colors[i].a );
+        pocketed |= s->pocketed[i] ? (uint32_t) 1 << i : 0;
+    }
+
+    writeUint32( file, pocketed );
+
+    for ( int i = 0; i < 2; i++ ) {
+        writeUint8( file, (uint8_t) s->groups[i] );
+        writeUint32( file, s->cueStickPocketed[i] );
+        writeInt32( file, s->scores[i] );
+    }
+
+    writeUint32( file, s->ballsOn );
+
+    writeUint8( file, (uint8_t) ( s->currentCueStick + 1 ) );
+    writeUint8( file, (uint8_t) ( s->lastCueStick + 1 ) );
+    writeUint8( file, (uint8_t) ( s->winnerCueStick + 1 ) );
+    writeUint8( file, (uint8_t) s->state );
+
+    writeUint8( file, (uint8_t) s->pocketedCount );
+    for ( int i = 0; i < s->pocketedCount; i++ ) {
+        writeUint8( file, (uint8_t) s->pocketedBalls[i] );
+    }
+
+    writeInt32( file, s->statistics.cueBallHits );
+    writeInt32( file, s->statistics.cueBallFirstHitNumber );
+    writeUint8( file, s->statistics.cueBallPocketed );
+    writeUint32( file, s->statistics.touchedCushion );
+    writeUint32( file, s->statistics.pocketed );
+
+    writeUint64( file, s->rngState );
+
+}
+
+static bool readSnapshot( FILE *file, GameSnapshot *s ) {
+
+    uint32_t pocketed;
+    uint8_t v[4];
+    bool ok = readUint8( file, &v[0] ) && v[0] >= 1 && v[0] <= BALL_CAPACITY;
+
+    s->ballCount = ok ? v[0] : 0;
+
+    for ( int i = 0; ok && i < s->ballCount; i++ ) {
+        ok = readFloat( file, &s->centers[i].x ) &&
+             readFloat( file, &s->centers[i].y ) &&
+             readUint8( file, &v[0] ) &&
+             readUint8( file, &v[1] ) &&
+             readUint8( file, &s->colors[i].r ) &&
+             readUint8( file, &s->colors[i].g ) &&
+             readUint8( file, &s->colors[i].b ) &&
+             readUint8( file, &s->colors[i].a );
+        s->numbers[i] = v[0];
+        s->striped[i] = v[1] != 0;
+    }
+
+    ok = ok && readUint32( file, &pocketed );
+
+    for ( int i = 0; ok && i < 2; i++ ) {
+        ok = readUint8( file, &v[0] ) &&
+             readUint32( file, &s->cueStickPocketed[i] ) &&
+             readInt32( file, &s->scores[i] ) &&
+             v[0] <= BALL_GROUP_STRIPED;
+        s->groups[i] = (BallGroup) v[0];
+    }
+
+    ok = ok && readUint32( file, &s->ballsOn );
+
+    // none or one of the two cue sticks, and there is always a current one
+    for ( int i = 0; ok && i < 3; i++ ) {
+        ok = readUint8( file, &v[i] ) && v[i] <= 2;
+    }
+
+    ok = ok && readUint8( file, &v[3] ) && v[3] <= GAME_STATE_GAME_OVER && v[0] > 0;
+
+    if ( ok ) {
+        s->currentCueStick = (int) v[0] - 1;
+        s->lastCueStick = (int) v[1] - 1;
+        s->winnerCueStick = (int) v[2] - 1;
+        s->state = (GameState) v[3];
+    }
+
+    ok = ok && readUint8( file, &v[0] ) && v[0] < s->ballCount;
+    s->pocketedCount = ok ? v[0] : 0;
+    for ( int i = 0; ok && i < s->pocketedCount; i++ ) {
+        ok = readUint8( file, &v[0] ) && v[0] < s->ballCount;
+        s->pocketedBalls[i] = v[0];
+    }
+
+    ok = ok && readInt32( file, &s->statistics.cueBallHits );
+    ok = ok && readInt32( file, &s->statistics.cueBallFirstHitNumber );
+    ok = ok && readUint8( file, &v[0] );
+    s->statistics.cueBallPocketed = v[0] != 0;
+    ok = ok && readUint32( file, &s->statistics.touchedCushion );
+    ok = ok && readUint32( file, &s->statistics.pocketed );
+
+    ok = ok && readUint64( file, &s->rngState );
+
+    for ( int i = 0; i < s->ballCount; i++ ) {
+        s->pocketed[i] = ( pocketed >> i ) & 1;
+    }
+
+    return ok;
+
+}
@@ -0,0 +1,445 @@
+/**
+ * @file SaveGame.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Saved match implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "raylib/raylib.h"
+
+#include "BallBatch.h"
+#include "BinaryIO.h"
+#include "CommonMacros.h"
+#include "ContactSolver.h"
+#include "Cushion.h"
+#include "Determinism.h"
+#include "GameRules.h"
+#include "SaveGame.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "Types.h"
+
+static void writeVector2( FILE *file, Vector2 v );
+static void writeColor( FILE *file, Color c );
+static void writeBall( FILE *file, const Ball *b );
+static void writeCueStick( FILE *file, const CueStick *cs );
+static void writeStatistics( FILE *file, const TurnStatistics *s );
+static bool readVector2( FILE *file, Vector2 *v );
+static bool readColor( FILE *file, Color *c );
+static bool readBool( FILE *file, bool *value );
+static bool readInt( FILE *file, int *value );
+static bool readBall( FILE *file, Ball *b );
+static bool readCueStick( FILE *file, CueStick *cs );
+static bool readStatistics( FILE *file, TurnStatistics *s );
+static uint32_t checksumFile( FILE *file, long size );
+
+bool saveGameWorld( const GameWorld *gw, const char *path ) {
+
+    char tempPath[512];
+    snprintf( tempPath, sizeof( tempPath ), "%s.tmp", path );
+
+    FILE *file = fopen( tempPath, "w+b" );
+
+    if ( file == NULL ) {
+        return false;
+    }
+
+    writeUint8( file, 'E' );
+    writeUint8( file, 'B' );
+    writeUint8( file, 'P' );
+    writeUint8( file, 'S' );
+    writeUint16( file, SAVE_GAME_VERSION );
+    writeUint16( file, (uint16_t) gw->ballCount );
+
+    // table
+    writeFloat( file, gw->boundarie.x );
+    writeFloat( file, gw->boundarie.y );
+    writeFloat( file, gw->boundarie.width );
+    writeFloat( file, gw->boundarie.height );
+    writeInt32( file, gw->marksSpacing );
+
+    for ( int i = 0; i < 6; i++ ) {
+        for ( int j = 0; j < 4; j++ ) {
+            writeVector2( file, gw->cushions[i].vertices[j] );
+        }
+    }
+
+    for ( int i = 0; i < 6; i++ ) {
+        writeVector2( file, gw->pockets[i].center );
+        writeInt32( file, gw->pockets[i].radius );
+    }
+
+    // balls and players
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        Ball b = ballFromBatch( &gw->physics, gw->balls, i );
+        writeBall( file, &b );
+    }
+
+    writeUint8( file, (uint8_t) ( gw->cueBall - gw->balls ) );
+    writeCueStick( file, &gw->cueStickP1 );
+    writeCueStick( file, &gw->cueStickP2 );
+    writeUint8( file, (uint8_t) ( cueStickToIndex( gw, gw->currentCueStick ) + 1 ) );
+    writeUint8( file, (uint8_t) ( cueStickToIndex( gw, gw->lastCueStick ) + 1 ) );
+    writeUint8( file, (uint8_t) ( cueStickToIndex( gw, gw->winnerCueStick ) + 1 ) );
+
+    // rules and simulation
+    writeUint8( file, (uint8_t) gw->rulesType );
+    writeUint8( file, (uint8_t) gw->state );
+    writeUint8( file, (uint8_t) gw->ballsState );
+    writeUint8( file, (uint8_t) gw->pocketedCount );
+    for ( int i = 0; i < gw->pocketedCount; i++ ) {
+        writeUint8( file, (uint8_t) gw->pocketedBalls[i] );
+    }
+    writeUint8( file, gw->applyRules );
+    writeUint32( file, gw->ballsOn );
+
+    writeFloat( file, gw->clock.fixedDelta );
+    writeFloat( file, gw->clock.accumulator );
+    writeInt32( file, gw->clock.maxStepsPerFrame );
+    writeUint8( file, (uint8_t) gw->clock.quality );
+
+    // the sweep order carries over between steps and decides the pair order
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        writeUint8( file, (uint8_t) gw->broadphase.order[i] );
+    }
+
+    // and so do the contact impulses, the first guess of the solver; only
+    // the pairs solved in the last step have one
+    writeUint16( file, (uint16_t) gw->contactSolver.solvedCount );
+    for ( int i = 0; i < gw->contactSolver.solvedCount; i++ ) {
+        int pair = gw->contactSolver.solvedPairs[i];
+        writeUint16( file, (uint16_t) pair );
+        writeFloat( file, gw->contactSolver.impulses[pair] );
+    }
+
+    writeUint64( file, gw->rng.state );
+    writeUint32( file, gw->checksum );
+    writeStatistics( file, &gw->statistics );
+
+    writeUint32( file, checksumGameWorld( (GameWorld*) gw ) );
+
+    // and of every byte written, for what the world checksum leaves out
+    long size = ftell( file );
+    writeUint32( file, checksumFile( file, size ) );
+
+    bool ok = !ferror( file ) && size > 0;
+    ok = fclose( file ) == 0 && ok;
+
+    // rename does not replace an existing file on every platform
+    if ( ok ) {
+        remove( path );
+        ok = rename( tempPath, path ) == 0;
+    } else {
+        remove( tempPath );
+    }
+
+    return ok;
+
+}
+
+bool loadGameWorld( GameWorld *gw, const char *path ) {
+
+    FILE *file = fopen( path, "rb" );
+
+    if ( file == NULL ) {
+        return false;
+    }
+
+    GameWorld loaded = { 0 };
+    uint8_t magic[4];
+    uint16_t version;
+    uint16_t ballCount;
+    uint16_t pair;
+    uint8_t v[4];
+    uint32_t checksum;
+    bool ok = fseek( file, 0, SEEK_END ) == 0;
+    long size = ftell( file ) - 4;
+
+    ok = ok && size > 0 && fseek( file, size, SEEK_SET ) == 0 &&
+         readUint32( file, &checksum ) && checksum == checksumFile( file, size );
+    ok = ok && fseek( file, 0, SEEK_SET ) == 0;
+
+    for ( int i = 0; i < 4; i++ ) {
+        ok = ok && readUint8( file, &magic[i] );
+    }
+
+    ok = ok && magic[0] == 'E' && magic[1] == 'B' && magic[2] == 'P' && magic[3] == 'S';
+    // the checksum of the world changed in version 5, older saves can't be verified
+    ok = ok && readUint16( file, &version ) && version == SAVE_GAME_VERSION;
+    ok = ok && readUint16( file, &ballCount ) && ballCount >= 1 && ballCount <= BALL_CAPACITY;
+    loaded.ballCount = ok ? ballCount : 0;
+
+    ok = ok && readFloat( file, &loaded.boundarie.x ) &&
+               readFloat( file, &loaded.boundarie.y ) &&
+               readFloat( file, &loaded.boundarie.width ) &&
+               readFloat( file, &loaded.boundarie.height ) &&
+               readInt( file, &loaded.marksSpacing );
+
+    for ( int i = 0; ok && i < 6; i++ ) {
+        for ( int j = 0; ok && j < 4; j++ ) {
+            ok = readVector2( file, &loaded.cushions[i].vertices[j] );
+        }
+        setupCushion( &loaded.cushions[i] );
+    }
+
+    for ( int i = 0; ok && i < 6; i++ ) {
+        ok = readVector2( file, &loaded.pockets[i].center ) &&
+             readInt( file, &loaded.pockets[i].radius );
+    }
+
+    for ( int i = 0; ok && i < loaded.ballCount; i++ ) {
+        ok = readBall( file, &loaded.balls[i] );
+    }
+
+    if ( ok ) {
+        loadBallBatch( &loaded.physics, loaded.balls, loaded.ballCount );
+    }
+
+    ok = ok && readUint8( file, &v[0] ) && v[0] < loaded.ballCount;
+    loaded.cueBall = ok ? &loaded.balls[v[0]] : NULL;
+    ok = ok && readCueStick( file, &loaded.cueStickP1 ) && readCueStick( file, &loaded.cueStickP2 );
+
+    for ( int i = 0; ok && i < 3; i++ ) {
+        ok = readUint8( file, &v[i] ) && v[i] <= 2;
+    }
+
+    if ( ok ) {
+        loaded.currentCueStick = indexToCueStick( &loaded, (int) v[0] - 1 );
+        loaded.lastCueStick = indexToCueStick( &loaded, (int) v[1] - 1 );
+        loaded.winnerCueStick = indexToCueStick( &loaded, (int) v[2] - 1 );
+        ok = loaded.currentCueStick != NULL;
+    }
+
+    // the balls racked must be the ones of the game
+    ok = ok && readUint8( file, &v[0] ) && v[0] < GAME_RULES_COUNT &&
+         loaded.ballCount == getGameRules( (GameRulesType) v[0] )->layout.ballCount;
+    loaded.rulesType = (GameRulesType) v[0];
+
+    ok = ok && readUint8( file, &v[0] ) && readUint8( file, &v[1] ) && readUint8( file, &v[2] ) && v[2] < loaded.ballCount;
+    loaded.state = (GameState) v[0];
+    loaded.ballsState = (GameBallsState) v[1];
+    loaded.pocketedCount = v[2];
+
+    for ( int i = 0; ok && i < loaded.pocketedCount; i++ ) {
+        ok = readUint8( file, &v[0] );
+        loaded.pocketedBalls[i] = v[0];
+    }
+
+    ok = ok && readBool( file, &loaded.applyRules );
+    ok = ok && readUint32( file, &loaded.ballsOn );
+    ok = ok && readFloat( file, &loaded.clock.fixedDelta ) &&
+               readFloat( file, &loaded.clock.accumulator ) &&
+               readInt( file, &loaded.clock.maxStepsPerFrame ) &&
+               loaded.clock.fixedDelta > 0.0f;
+
+    ok = ok && readUint8( file, &v[0] ) && v[0] <= SIMULATION_QUALITY_HIGH;
+    loaded.clock.quality = (SimulationQuality) v[0];
+    loaded.clock.preset = getSimulationPreset( loaded.clock.quality );
+
+    for ( int i = 0; ok && i < loaded.ballCount; i++ ) {
+        ok = readUint8( file, &v[0] ) && v[0] < loaded.ballCount;
+        loaded.broadphase.order[i] = v[0];
+    }
+
+    ok = ok && readUint16( file, &pair ) && pair <= CONTACT_SOLVER_MAX_CONTACTS;
+    loaded.contactSolver.solvedCount = ok ? pair : 0;
+
+    for ( int i = 0; ok && i < loaded.contactSolver.solvedCount; i++ ) {
+        ok = readUint16( file, &pair ) && pair < CONTACT_SOLVER_MAX_CONTACTS &&
+             readFloat( file, &loaded.contactSolver.impulses[pair] );
+        loaded.contactSolver.solvedPairs[i] = pair;
+    }
+
+    ok = ok && readUint64( file, &loaded.rng.state ) && loaded.rng.state != 0;
+    ok = ok && readUint32( file, &loaded.checksum );
+    ok = ok && readStatistics( file, &loaded.statistics );
+    ok = ok && readUint32( file, &checksum ) && checksum == checksumGameWorld( &loaded );
+    ok = ok && ftell( file ) == size;
+
+    fclose( file );
+
+    if ( ok ) {
+        cloneGameWorld( gw, &loaded );
+    }
+
+    return ok;
+
+}
+
+static void writeVector2( FILE *file, Vector2 v ) {
+    writeFloat( file, v.x );
+    writeFloat( file, v.y );
+}
+
+static void writeColor( FILE *file, Color c ) {
+    writeUint8( file, c.r );
+    writeUint8( file, c.g );
+    writeUint8( file, c.b );
+    writeUint8( file, c.a );
+}
+
+static void writeBall( FILE *file, const Ball *b ) {
+    writeVector2( file, b->center );
+    writeVector2( file, b->prevPos );
+    writeVector2( file, b->spin );
+    writeInt32( file, b->radius );
+    writeVector2( file, b->vel );
+    writeFloat( file, b->friction );
+    writeFloat( file, b->elasticity );
+    writeUint8( file, b->moving );
+    writeColor( file, b->color );
+    writeUint8( file, b->striped );
+    writeUint8( file, b->plain );
+    writeUint8( file, (uint8_t) b->number );
+    writeUint8( file, b->pocketed );
+}
+
+static void writeCueStick( FILE *file, const CueStick *cs ) {
+
+    writeVector2( file, cs->target );
+    writeFloat( file, cs->distanceFromTarget );
+    writeFloat( file, cs->size );
+    writeFloat( file, cs->angle );
+    writeInt32( file, cs->powerTick );
+    writeInt32( file, cs->power );
+    writeInt32( file, cs->minPower );
+    writeInt32( file, cs->maxPower );
+    writeVector2( file, cs->hitPoint );
+    writeColor( file, cs->color );
+
+    writeUint32( file, cs->pocketed );
+    writeInt32( file, cs->score );
+    writeUint8( file, (uint8_t) cs->type );
+    writeUint8( file, (uint8_t) cs->state );
+    writeUint8( file, (uint8_t) cs->group );
+
+}
+
+static void writeStatistics( FILE *file, const TurnStatistics *s ) {
+    writeInt32( file, s->cueBallHits );
+    writeInt32( file, s->cueBallFirstHitNumber );
+    writeUint8( file, s->cueBallPocketed );
+    writeUint32( file, s->touchedCushion );
+    writeUint32( file, s->pocketed );
+}
+
+static bool readVector2( FILE *file, Vector2 *v ) {
+    return readFloat( file, &v->x ) && readFloat( file, &v->y );
+}
+
+static bool readColor( FILE *file, Color *c ) {
+    return readUint8( file, &c->r ) &&
+           readUint8( file, &c->g ) &&
+           readUint8( file, &c->b ) &&
+           readUint8( file, &c->a );
+}
+
+static bool readBool( FILE *file, bool *value ) {
+    uint8_t v;
+    bool ok = readUint8( file, &v );
+    *value = v != 0;
+    return ok;
+}
+
+static bool readInt( FILE *file, int *value ) {
+    int32_t v;
+    bool ok = readInt32( file, &v );
+    *value = v;
+    return ok;
+}
+
+static bool readBall( FILE *file, Ball *b ) {
+
+    uint8_t number;
+
+    bool ok = readVector2( file, &b->center ) &&
+              readVector2( file, &b->prevPos ) &&
+              readVector2( file, &b->spin ) &&
+              readInt( file, &b->radius ) &&
+              readVector2( file, &b->vel ) &&
+              readFloat( file, &b->friction ) &&
+              readFloat( file, &b->elasticity ) &&
+              readBool( file, &b->moving ) &&
+              readColor( file, &b->color ) &&
+              readBool( file, &b->striped ) &&
+              readBool( file, &b->plain ) &&
+              readUint8( file, &number ) &&
+              readBool( file, &b->pocketed );
+
+    b->number = number;
+
+    return ok && number < BALL_CAPACITY;
+
+}
+
+static bool readCueStick( FILE *file, CueStick *cs ) {
+
+    uint8_t v[3] = { 0 };
+
+    bool ok = readVector2( file, &cs->target ) &&
+              readFloat( file, &cs->distanceFromTarget ) &&
+              readFloat( file, &cs->size ) &&
+              readFloat( file, &cs->angle ) &&
+              readInt( file, &cs->powerTick ) &&
+              readInt( file, &cs->power ) &&
+              readInt( file, &cs->minPower ) &&
+              readInt( file, &cs->maxPower ) &&
+              readVector2( file, &cs->hitPoint ) &&
+              readColor( file, &cs->color );
+
+    ok = ok && readUint32( file, &cs->pocketed ) && readInt( file, &cs->score );
+
+    for ( int i = 0; ok && i < 3; i++ ) {
+        ok = readUint8( file, &v[i] );
+    }
+
+    cs->type = (CueStickType) v[0];
+    cs->state = (CueStickState) v[1];
+    cs->group = (BallGroup) v[2];
+
+    return ok;
+
+}
+
+static bool readStatistics( FILE *file, TurnStatistics *s ) {
+    return readInt( file, &s->cueBallHits ) &&
+           readInt( file, &s->cueBallFirstHitNumber ) &&
+           readBool( file, &s->cueBallPocketed ) &&
+           readUint32( file, &s->touchedCushion ) &&
+           readUint32( file, &s->pocketed );
+}
+
+/**
+ * @brief Hash of the first size bytes of file, leaving the position at the
+ * byte after them.
+ */
+static uint32_t checksumFile( FILE *file, long size ) {
+
+    uint8_t buffer[512];
+    uint32_t hash = CHECKSUM_START;
+    long left = size;
+
+    fflush( file );
+    fseek( file, 0, SEEK_SET );
+
+    while ( left > 0 ) {
+        size_t n = fread( buffer, 1, left < (long) sizeof( buffer ) ? (size_t) left : sizeof( buffer ), file );
+        if ( n == 0 ) {
+            break;
+        }
+        hash = checksumBytes( hash, buffer, n );
+        left -= (long) n;
+    }
+
+    // switching from reading to writing needs a positioning call
+    fseek( file, size, SEEK_SET );
+
+    return hash;
+
+}
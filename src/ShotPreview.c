@@ -0,0 +1,246 @@
+/**
+ * @file ShotPreview.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Shot preview implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <pthread.h>
+
+#include "raylib/raylib.h"
+
+#include "CommonMacros.h"
+#include "ShotPreview.h"
+#include "Simulation.h"
+#include "Types.h"
+
+// steps simulated by each updateShotPreview when there is no worker thread
+#define STEPS_PER_UPDATE 240
+
+typedef struct ShotPreviewRequest {
+    GameWorld world;            // struck, ready to be stepped
+    int generation;
+    int steps;
+} ShotPreviewRequest;
+
+typedef struct ShotPreviewWorker {
+    bool threaded;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;            // a request was made or the worker must quit
+    int quit;                       // atomic
+    int generation;                 // atomic, jobs of older requests stop
+    ShotPreviewRequest *pending;    // atomic, handed to the worker
+    ShotPreviewResult *published;   // atomic, handed to the game loop
+    ShotPreviewRequest *job;        // worker side only
+} ShotPreviewWorker;
+
+static void *workerThread( void *data );
+static void runJob( ShotPreviewWorker *worker, int maxSteps );
+static void dropJob( ShotPreviewWorker *worker );
+static void publishResult( ShotPreviewWorker *worker, ShotPreviewRequest *job );
+
+void setupShotPreview( ShotPreview *sp ) {
+
+    sp->enabled = false;
+    sp->generation = 0;
+    sp->hasResult = false;
+    sp->worker = (ShotPreviewWorker*) calloc( 1, sizeof( ShotPreviewWorker ) );
+
+    if ( sp->worker != NULL ) {
+        pthread_mutex_init( &sp->worker->lock, NULL );
+        pthread_cond_init( &sp->worker->wake, NULL );
+        sp->worker->threaded = pthread_create( &sp->worker->thread, NULL, workerThread, sp->worker ) == 0;
+    }
+
+}
+
+void destroyShotPreview( ShotPreview *sp ) {
+
+    ShotPreviewWorker *worker = sp->worker;
+
+    if ( worker == NULL ) {
+        return;
+    }
+
+    if ( worker->threaded ) {
+        pthread_mutex_lock( &worker->lock );
+        __atomic_store_n( &worker->quit, 1, __ATOMIC_RELAXED );
+        __atomic_add_fetch( &worker->generation, 1, __ATOMIC_RELEASE );
+        pthread_cond_signal( &worker->wake );
+        pthread_mutex_unlock( &worker->lock );
+        pthread_join( worker->thread, NULL );
+    }
+
+    pthread_cond_destroy( &worker->wake );
+    pthread_mutex_destroy( &worker->lock );
+
+    free( worker->job );
+    free( __atomic_exchange_n( &worker->pending, NULL, __ATOMIC_ACQUIRE ) );
+    free( __atomic_exchange_n( &worker->published, NULL, __ATOMIC_ACQUIRE ) );
+    free( worker );
+    sp->worker = NULL;
+    sp->hasResult = false;
+
+}
+
+void requestShotPreview( ShotPreview *sp, const GameWorld *gw ) {
+
+    ShotPreviewWorker *worker = sp->worker;
+
+    cancelShotPreview( sp );
+
+    if ( worker == NULL ) {
+        return;
+    }
+
+    ShotPreviewRequest *request = (ShotPreviewRequest*) malloc( sizeof( ShotPreviewRequest ) );
+
+    if ( request == NULL ) {
+        return;
+    }
+
+    cloneGameWorld( &request->world, gw );
+    strikeCueBall( &request->world );
+    request->generation = sp->generation;
+    request->steps = 0;
+
+    // a request the worker didn't take yet is superseded
+    free( __atomic_exchange_n( &worker->pending, request, __ATOMIC_ACQ_REL ) );
+
+    if ( worker->threaded ) {
+        pthread_mutex_lock( &worker->lock );
+        pthread_cond_signal( &worker->wake );
+        pthread_mutex_unlock( &worker->lock );
+    }
+
+}
+
+void cancelShotPreview( ShotPreview *sp ) {
+
+    sp->generation++;
+    sp->hasResult = false;
+
+    if ( sp->worker != NULL ) {
+        __atomic_store_n( &sp->worker->generation, sp->generation, __ATOMIC_RELEASE );
+    }
+
+}
+
+bool updateShotPreview( ShotPreview *sp ) {
+
+    ShotPreviewWorker *worker = sp->worker;
+
+    if ( worker == NULL ) {
+        return false;
+    }
+
+    if ( !worker->threaded ) {
+        runJob( worker, STEPS_PER_UPDATE );
+    }
+
+    ShotPreviewResult *result = __atomic_exchange_n( &worker->published, NULL, __ATOMIC_ACQ_REL );
+
+    if ( result != NULL ) {
+        if ( result->generation == sp->generation ) {
+            sp->result = *result;
+            sp->hasResult = true;
+        }
+        free( result );
+    }
+
+    return sp->hasResult;
+
+}
+
+static void *workerThread( void *data ) {
+
+    ShotPreviewWorker *worker = (ShotPreviewWorker*) data;
+
+    // idle, the worker sleeps until a request is made
+    pthread_mutex_lock( &worker->lock );
+
+    while ( !__atomic_load_n( &worker->quit, __ATOMIC_RELAXED ) ) {
+        if ( worker->job == NULL && __atomic_load_n( &worker->pending, __ATOMIC_RELAXED ) == NULL ) {
+            pthread_cond_wait( &worker->wake, &worker->lock );
+        } else {
+            pthread_mutex_unlock( &worker->lock );
+            runJob( worker, SIMULATION_MAX_SHOT_STEPS );
+            pthread_mutex_lock( &worker->lock );
+        }
+    }
+
+    pthread_mutex_unlock( &worker->lock );
+
+    return NULL;
+
+}
+
+/**
+ * @brief Takes the pending request if there is no job and steps the job up
+ * to maxSteps times. The job is dropped as soon as a newer request exists
+ * and its result is published when every ball stopped.
+ */
+static void runJob( ShotPreviewWorker *worker, int maxSteps ) {
+
+    if ( worker->job == NULL ) {
+        worker->job = __atomic_exchange_n( &worker->pending, NULL, __ATOMIC_ACQ_REL );
+        if ( worker->job == NULL ) {
+            return;
+        }
+    }
+
+    ShotPreviewRequest *job = worker->job;
+    GameWorld *gw = &job->world;
+
+    for ( int i = 0; i < maxSteps; i++ ) {
+
+        if ( __atomic_load_n( &worker->generation, __ATOMIC_ACQUIRE ) != job->generation ) {
+            dropJob( worker );
+            return;
+        }
+
+        if ( gw->ballsState != GAME_STATE_BALLS_MOVING || job->steps == SIMULATION_MAX_SHOT_STEPS ) {
+            publishResult( worker, job );
+            dropJob( worker );
+            return;
+        }
+
+        simulateNextStep( gw );
+        job->steps++;
+
+    }
+
+}
+
+static void dropJob( ShotPreviewWorker *worker ) {
+    free( worker->job );
+    worker->job = NULL;
+}
+
+static void publishResult( ShotPreviewWorker *worker, ShotPreviewRequest *job ) {
+
+    ShotPreviewResult *result = (ShotPreviewResult*) malloc( sizeof( ShotPreviewResult ) );
+
+    if ( result == NULL ) {
+        return;
+    }
+
+    result->generation = job->generation;
+
+    for ( int i = 0; i < job->world.ballCount; i++ ) {
+        result->positions[i] = (Vector2) { job->world.physics.x[i], job->world.physics.y[i] };
+        result->pocketed[i] = job->world.physics.pocketed[i];
+    }
+
+    // a pocketed cue ball is already back on the table
+    result->pocketed[0] = job->world.statistics.cueBallPocketed;
+
+    // a result the game loop didn't take yet is superseded
+    free( __atomic_exchange_n( &worker->published, result, __ATOMIC_ACQ_REL ) );
+
+}
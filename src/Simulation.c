@@ -0,0 +1,836 @@
+/**
+ * @file Simulation.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless shot simulation implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+
+#include "Ball.h"
+#include "BallBatch.h"
+#include "BallMask.h"
+#include "BallMotion.h"
+#include "Broadphase.h"
+#include "CommonMacros.h"
+#include "ContactSolver.h"
+#include "Determinism.h"
+#include "GameRules.h"
+#include "PositionTrace.h"
+#include "Simulation.h"
+#include "SimulationEvents.h"
+#include "Types.h"
+
+// bounds the work of a step where balls keep hitting each other
+#define MAX_BALL_CONTACTS_PER_STEP 64
+
+// the stepped physics rolls a little further than the analytic motion
+#define QUIET_REACH_SCALE 1.01f
+#define QUIET_REACH_MARGIN 1.0f
+
+static void collideWithCushions( GameWorld *gw, int i );
+static void resolveBallContacts( GameWorld *gw, bool *awake, float delta );
+static void moveBallToTime( BallBatch *bb, int i, float from, float to );
+static void registerBallHit( GameWorld *gw, int a, int b, float impulse );
+static void pushBallEvent( GameWorld *gw, SimulationEventType type, int i, float value );
+static bool reachesCushion( GameWorld *gw, Vector2 center, float radius, float reach );
+static float fastestBallSpeed( const GameWorld *gw );
+static CueStick *rebaseCueStick( GameWorld *dst, const GameWorld *src, const CueStick *cs );
+
+void setupSimulationClock( SimulationClock *clock, int frameRate, SimulationQuality quality, int maxStepsPerFrame ) {
+    clock->quality = quality;
+    clock->preset = getSimulationPreset( quality );
+    clock->fixedDelta = 1.0f / ( frameRate * clock->preset.substeps );
+    clock->accumulator = 0.0f;
+    clock->maxStepsPerFrame = maxStepsPerFrame;
+}
+
+SimulationPreset getSimulationPreset( SimulationQuality quality ) {
+
+    switch ( quality ) {
+
+        // 1/60s steps, split only for the fastest shots
+        case SIMULATION_QUALITY_LOW:
+            return (SimulationPreset) {
+                .substeps = 1,
+                .maxDisplacement = 2.0f,
+                .maxSplits = 2,
+                .mergeDisplacement = 0.1f,
+                .maxMerges = 4
+            };
+
+        case SIMULATION_QUALITY_MEDIUM:
+            return (SimulationPreset) {
+                .substeps = 2,
+                .maxDisplacement = 1.0f,
+                .maxSplits = 4,
+                .mergeDisplacement = 0.1f,
+                .maxMerges = 2
+            };
+
+        // fast balls never move more than half a radius in a step
+        case SIMULATION_QUALITY_HIGH:
+        default:
+            return (SimulationPreset) {
+                .substeps = 2,
+                .maxDisplacement = 0.5f,
+                .maxSplits = 8,
+                .mergeDisplacement = 0.05f,
+                .maxMerges = 2
+            };
+
+    }
+
+}
+
+int planClockStep( const GameWorld *gw ) {
+
+    const SimulationClock *clock = &gw->clock;
+    float travel = fastestBallSpeed( gw ) * clock->fixedDelta;
+    int merges = clock->preset.maxMerges;
+
+    while ( merges > 1 && travel * merges > clock->preset.mergeDisplacement * gw->cueBall->radius ) {
+        merges--;
+    }
+
+    return merges;
+
+}
+
+SimulationStepReport simulateClockStep( GameWorld *gw, int fixedSteps ) {
+
+    const SimulationClock *clock = &gw->clock;
+    float delta = clock->fixedDelta * fixedSteps;
+    float travel = fastestBallSpeed( gw ) * delta;
+    int splits = (int) ceilf( travel / ( clock->preset.maxDisplacement * gw->cueBall->radius ) );
+
+    if ( splits < 1 ) {
+        splits = 1;
+    } else if ( splits > clock->preset.maxSplits ) {
+        splits = clock->preset.maxSplits;
+    }
+
+    SimulationStepReport total = { 0 };
+
+    for ( int i = 0; i < splits; i++ ) {
+        SimulationStepReport step = simulateStep( gw, delta / splits );
+        mergeStepReport( &total, &step );
+    }
+
+    return total;
+
+}
+
+SimulationStepReport simulateNextStep( GameWorld *gw ) {
+    return simulateClockStep( gw, planClockStep( gw ) );
+}
+
+SimulationStepReport simulateStep( GameWorld *gw, float delta ) {
+
+    SimulationStepReport report = { 0 };
+    BallBatch *bb = &gw->physics;
+    uint32_t firstEvent = gw->events.written;
+
+    // sleeping balls (not moving) are left out of integration, cushions and
+    // pockets until a contact wakes them up
+    bool awake[BALL_CAPACITY];
+
+    // positions at the start of the step (needed for cushion collision)
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        bb->px[i] = bb->x[i];
+        bb->py[i] = bb->y[i];
+        awake[i] = !bb->pocketed[i] && bb->moving[i];
+    }
+
+    // integration, several balls at a time; the decay is scaled by delta,
+    // so the distance travelled does not depend on how many steps are taken
+    float velDecay = (float) portablePow( gw->cueBall->friction, delta * BALL_DECAY_RATE );
+    float spinDecay = (float) portablePow( BALL_SPIN_DECAY, delta * BALL_DECAY_RATE );
+
+    integrateBallBatch( bb, gw->ballCount, delta, velDecay, spinDecay );
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        if ( awake[i] ) {
+            collideWithCushions( gw, i );
+        }
+    }
+
+    // ball x ball, only in the islands of balls that move
+    updateBroadphase( &gw->broadphase, bb, gw->ballCount );
+    buildBroadphaseIslands( &gw->broadphase, awake, gw->ballCount );
+
+    resolveBallContacts( gw, awake, delta );
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+
+        // balls woken up by a contact this step reach the pockets in the next one
+        if ( bb->pocketed[i] || !awake[i] ) {
+            if ( !bb->pocketed[i] && bb->moving[i] ) {
+                report.ballsMoving = true;
+            }
+            continue;
+        }
+
+        // ball x pockets
+        Vector2 center = { bb->x[i], bb->y[i] };
+
+        for ( int j = 0; j < 6; j++ ) {
+
+            float dist = Vector2Distance( center, gw->pockets[j].center );
+
+            // more than 50% of ball is inside the pocket
+            if ( dist < gw->pockets[j].radius - bb->radius[i] * 0.5f ) {
+                pocketBall( gw, i );
+                break;
+            }
+
+        }
+
+        if ( bb->moving[i] ) {
+            report.ballsMoving = true;
+        } else if ( !bb->pocketed[i] ) {
+            pushBallEvent( gw, SIMULATION_EVENT_BALL_STOPPED, i, 0.0f );
+        }
+
+    }
+
+    report.events = gw->events.written - firstEvent;
+    applySimulationEvents( gw );
+
+    int cueBall = gw->cueBall - gw->balls;
+    gw->currentCueStick->target = (Vector2) { bb->x[cueBall], bb->y[cueBall] };
+
+    if ( report.ballsMoving ) {
+        gw->ballsState = GAME_STATE_BALLS_MOVING;
+    } else {
+        // the balls came to rest: the view is what the game and the rules see next
+        storeBallBatch( bb, gw->balls, gw->ballCount );
+        gw->ballsState = GAME_STATE_BALLS_STOPPED;
+    }
+
+    return report;
+
+}
+
+SimulationStepReport advanceSimulation( GameWorld *gw, float frameDelta, PositionTrace *trace ) {
+
+    SimulationStepReport total = { 0 };
+    SimulationClock *clock = &gw->clock;
+
+    // no step may run this frame, so the balls keep their current state
+    total.ballsMoving = gw->ballsState == GAME_STATE_BALLS_MOVING;
+
+    clock->accumulator += frameDelta;
+    int steps = 0;
+
+    while ( steps < clock->maxStepsPerFrame ) {
+
+        int fixedSteps = planClockStep( gw );
+
+        // a merged step runs when all of its time is there
+        if ( clock->accumulator < clock->fixedDelta * fixedSteps ) {
+            break;
+        }
+
+        SimulationStepReport step = simulateClockStep( gw, fixedSteps );
+        mergeStepReport( &total, &step );
+
+        // the balls are too slow for the repeated frames of a merged step to show
+        for ( int i = 0; i < fixedSteps; i++ ) {
+            recordPositionTrace( trace, gw );
+        }
+
+        clock->accumulator -= clock->fixedDelta * fixedSteps;
+        steps += fixedSteps;
+
+    }
+
+    // the machine can't keep up: drops the time left instead of catching up later
+    if ( steps >= clock->maxStepsPerFrame && clock->accumulator >= clock->fixedDelta ) {
+        clock->accumulator = 0.0f;
+    }
+
+    // once a frame is enough to draw the balls that move
+    if ( steps > 0 && total.ballsMoving ) {
+        storeBallBatch( &gw->physics, gw->balls, gw->ballCount );
+    }
+
+    return total;
+
+}
+
+SimulationStepReport fastForwardSimulation( GameWorld *gw, int maxSteps, PositionTrace *trace ) {
+
+    SimulationStepReport total = { 0 };
+    total.ballsMoving = gw->ballsState == GAME_STATE_BALLS_MOVING;
+
+    int steps = 0;
+
+    // the same steps advanceSimulation takes, only without waiting for them
+    while ( total.ballsMoving && steps < maxSteps ) {
+
+        int fixedSteps = planClockStep( gw );
+        SimulationStepReport step = simulateClockStep( gw, fixedSteps );
+        mergeStepReport( &total, &step );
+
+        for ( int i = 0; i < fixedSteps; i++ ) {
+            recordPositionTrace( trace, gw );
+        }
+
+        steps += fixedSteps;
+
+    }
+
+    gw->clock.accumulator = 0.0f;
+
+    if ( steps > 0 && total.ballsMoving ) {
+        storeBallBatch( &gw->physics, gw->balls, gw->ballCount );
+    }
+
+    return total;
+
+}
+
+bool settleQuietBalls( GameWorld *gw ) {
+
+    BallBatch *bb = &gw->physics;
+    float reach[BALL_CAPACITY];
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        reach[i] = 0.0f;
+        if ( !bb->pocketed[i] && bb->moving[i] ) {
+            float speed = Vector2Length( (Vector2) { bb->vx[i], bb->vy[i] } );
+            reach[i] = ballStopDistance( &gw->balls[i], speed ) * QUIET_REACH_SCALE + QUIET_REACH_MARGIN;
+        }
+    }
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+
+        if ( reach[i] == 0.0f ) {
+            continue;
+        }
+
+        Vector2 center = { bb->x[i], bb->y[i] };
+
+        if ( reachesCushion( gw, center, bb->radius[i], reach[i] ) ) {
+            return false;
+        }
+
+        for ( int j = 0; j < 6; j++ ) {
+            float captureRadius = gw->pockets[j].radius - bb->radius[i] * 0.5f;
+            if ( Vector2Distance( center, gw->pockets[j].center ) - captureRadius <= reach[i] ) {
+                return false;
+            }
+        }
+
+        // the gap between two balls must be wider than what both can cover
+        for ( int j = 0; j < gw->ballCount; j++ ) {
+            if ( j != i && !bb->pocketed[j] ) {
+                float gap = Vector2Distance( center, (Vector2) { bb->x[j], bb->y[j] } ) - bb->radius[i] - bb->radius[j];
+                if ( gap <= reach[i] + reach[j] ) {
+                    return false;
+                }
+            }
+        }
+
+    }
+
+    // only friction is left: straight to the rest points
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        if ( reach[i] > 0.0f ) {
+            Ball b = ballFromBatch( bb, gw->balls, i );
+            Vector2 rest = ballRestPoint( &b );
+            bb->x[i] = bb->px[i] = rest.x;
+            bb->y[i] = bb->py[i] = rest.y;
+            bb->vx[i] = bb->vy[i] = 0.0f;
+            bb->sx[i] = bb->sy[i] = 0.0f;
+            bb->moving[i] = 0;
+        }
+    }
+
+    storeBallBatch( bb, gw->balls, gw->ballCount );
+
+    gw->currentCueStick->target = gw->cueBall->center;
+    gw->ballsState = GAME_STATE_BALLS_STOPPED;
+
+    return true;
+
+}
+
+void mergeStepReport( SimulationStepReport *total, SimulationStepReport *step ) {
+    total->events += step->events;
+    total->ballsMoving = step->ballsMoving;
+}
+
+void applySimulationEvents( GameWorld *gw ) {
+
+    SimulationEventBuffer *events = &gw->events;
+    const GameRules *rules = getGameRules( gw->rulesType );
+    int cueBallIndex = gw->cueBall - gw->balls;
+
+    for ( uint32_t i = events->stepStart; i < events->written; i++ ) {
+
+        SimulationEvent *e = &events->events[i % SIMULATION_EVENT_CAPACITY];
+        Ball *b = &gw->balls[e->a];
+
+        switch ( e->type ) {
+
+            case SIMULATION_EVENT_BALL_HIT:
+                if ( e->a == cueBallIndex ) {
+                    if ( gw->statistics.cueBallHits == 0 ) {
+                        gw->statistics.cueBallFirstHitNumber = gw->balls[e->b].number;
+                    }
+                    gw->statistics.cueBallHits++;
+                }
+                break;
+
+            case SIMULATION_EVENT_CUSHION_HIT:
+                if ( gw->statistics.cueBallHits > 0 || gw->state != GAME_STATE_BREAKING ) {
+                    gw->statistics.touchedCushion |= BALL_MASK( b->number );
+                }
+                break;
+
+            case SIMULATION_EVENT_BALL_POCKETED:
+                if ( e->a == cueBallIndex ) {
+                    gw->statistics.cueBallPocketed = true;
+                } else {
+                    gw->statistics.pocketed |= BALL_MASK( b->number );
+                    gw->pocketedBalls[gw->pocketedCount++] = b->number;
+                }
+                break;
+
+            default:
+                break;
+
+        }
+
+        rules->onEvent( gw, e );
+
+    }
+
+    endSimulationEventStep( events );
+
+}
+
+void collideBallWithCushion( GameWorld *gw, int i, Vector2 normal ) {
+
+    BallBatch *bb = &gw->physics;
+    Vector2 vel = { bb->vx[i], bb->vy[i] };
+    Vector2 spin = { bb->sx[i], bb->sy[i] };
+
+    // calculates the reflection of the velocity
+    float dotProduct = Vector2DotProduct( vel, normal );
+    pushBallEvent( gw, SIMULATION_EVENT_CUSHION_HIT, i, fabsf( dotProduct ) );
+
+    vel = Vector2Subtract( vel, Vector2Scale( normal, 2.0f * dotProduct ) );
+
+    // spin on reflection
+    if ( &gw->balls[i] == gw->cueBall && Vector2Length( spin ) > 0.01f ) {
+
+        bool isVertical = fabs( normal.x ) > fabs( normal.y );
+
+        if ( isVertical ) {
+            // vertical cushion, spin.x affects angle
+            float spinEffect = spin.x * 0.3f; // influence factor
+            vel.y += spinEffect * fabs( vel.x );
+        } else {
+            // horizontal cushion, spin.y affects angle
+            float spinEffect = spin.y * 0.3f; // influence factor
+            vel.x += spinEffect * fabs( vel.y );
+        }
+
+        // decrease spin after collision
+        spin = Vector2Scale( spin, 0.7f );
+
+    }
+
+    // applies elasticity
+    vel = Vector2Scale( vel, gw->balls[i].elasticity );
+
+    bb->vx[i] = vel.x;
+    bb->vy[i] = vel.y;
+    bb->sx[i] = spin.x;
+    bb->sy[i] = spin.y;
+
+    // apply some offset to prevent continuous collision
+    bb->x[i] += normal.x * 0.1f;
+    bb->y[i] += normal.y * 0.1f;
+
+}
+
+void pocketBall( GameWorld *gw, int i ) {
+
+    BallBatch *bb = &gw->physics;
+
+    pushBallEvent( gw, SIMULATION_EVENT_BALL_POCKETED, i, Vector2Length( (Vector2) { bb->vx[i], bb->vy[i] } ) );
+
+    bb->pocketed[i] = true;
+    bb->vx[i] = bb->vy[i] = 0.0f;
+    bb->moving[i] = 0;
+
+    // the rules know the spot of the cue ball
+    if ( &gw->balls[i] == gw->cueBall ) {
+        resetCueBallPosition( gw );
+        bb->x[i] = gw->cueBall->center.x;
+        bb->y[i] = gw->cueBall->center.y;
+        bb->pocketed[i] = false;
+    }
+
+}
+
+void strikeCueBall( GameWorld *gw ) {
+
+    CueStick *cc = gw->currentCueStick;
+    gw->cueBall->vel.x = cc->power * (float) portableCos( DEG2RAD * cc->angle );
+    gw->cueBall->vel.y = cc->power * (float) portableSin( DEG2RAD * cc->angle );
+
+    // applies the spin based on the point of impact
+    gw->cueBall->spin.x = cc->hitPoint.x * 2.0f; // side spin
+    gw->cueBall->spin.y = cc->hitPoint.y * 2.0f; // top/back spin
+
+    cc->state = CUE_STICK_STATE_READY;
+    gw->applyRules = true;
+
+    // impulses of the last shot are no guess for this one
+    setupContactSolver( &gw->contactSolver );
+
+    // the shot is in progress even if the clock doesn't step this frame
+    gw->cueBall->moving = true;
+    gw->ballsState = GAME_STATE_BALLS_MOVING;
+
+    // the shot is played from the balls as they are at rest
+    loadBallBatch( &gw->physics, gw->balls, gw->ballCount );
+
+}
+
+bool finishShot( GameWorld *gw ) {
+
+    if ( !gw->applyRules ) {
+        return false;
+    }
+
+    gw->lastCueStick = gw->currentCueStick;
+
+    if ( gw->currentCueStick == &gw->cueStickP1 ) {
+        gw->currentCueStick = &gw->cueStickP2;
+    } else {
+        gw->currentCueStick = &gw->cueStickP1;
+    }
+
+    // the rules judge the balls as they stopped and may place them again
+    storeBallBatch( &gw->physics, gw->balls, gw->ballCount );
+    getGameRules( gw->rulesType )->onShotEnd( gw );
+    loadBallBatch( &gw->physics, gw->balls, gw->ballCount );
+    resetTurnStatistics( gw );
+
+    gw->applyRules = false;
+    gw->checksum = checksumGameWorld( gw );
+
+    return true;
+
+}
+
+void cloneGameWorld( GameWorld *dst, const GameWorld *src ) {
+
+    *dst = *src;
+
+    dst->cueBall = &dst->balls[src->cueBall - src->balls];
+    dst->currentCueStick = rebaseCueStick( dst, src, src->currentCueStick );
+    dst->lastCueStick = rebaseCueStick( dst, src, src->lastCueStick );
+    dst->winnerCueStick = rebaseCueStick( dst, src, src->winnerCueStick );
+
+}
+
+int simulateShot( GameWorld *gw, float angle, int power, Vector2 hitPoint ) {
+
+    CueStick *cc = gw->currentCueStick;
+    cc->angle = angle;
+    cc->power = power;
+    cc->hitPoint = hitPoint;
+
+    strikeCueBall( gw );
+
+    int steps = 0;
+    SimulationStepReport report;
+
+    do {
+        report = simulateNextStep( gw );
+        steps++;
+    } while ( report.ballsMoving && steps < SIMULATION_MAX_SHOT_STEPS );
+
+    finishShot( gw );
+
+    return steps;
+
+}
+
+static void collideWithCushions( GameWorld *gw, int i ) {
+
+    BallBatch *bb = &gw->physics;
+
+    for ( int j = 0; j < 6; j++ ) {
+
+        Cushion *c = &gw->cushions[j];
+        CollisionResult collision = ballCushionCollision( bb, i, c );
+
+        if ( collision.hasCollision ) {
+
+            // puts the ball in the exact point of contact
+            bb->x[i] = bb->px[i] + ( bb->x[i] - bb->px[i] ) * collision.t;
+            bb->y[i] = bb->py[i] + ( bb->y[i] - bb->py[i] ) * collision.t;
+
+            collideBallWithCushion( gw, i, collision.normal );
+
+        }
+
+    }
+
+}
+
+/*
+ * Continuous ball x ball collision. While the contacts are resolved prevPos
+ * is where each ball is at its own time of the step and center is where it
+ * will be at the end of it, so the sweep of every pair covers the rest of
+ * the step. The balls of an island share their time. The earliest contact
+ * is taken first: the balls of its island are moved to its time, the group
+ * of balls touching the pair is solved together, the balls that got an
+ * impulse go on with the new velocities and only the pairs of balls whose
+ * path changed are swept again. A new path is checked against the balls of
+ * the other islands and the ones at rest, which join the island when they
+ * can be reached. A fast ball can't pass through another one anymore and a
+ * ball hit earlier in the step is the one that moves first.
+ */
+static void resolveBallContacts( GameWorld *gw, bool *awake, float delta ) {
+
+    BallBatch *bb = &gw->physics;
+    Broadphase *bp = &gw->broadphase;
+    BallContact contacts[CONTACT_SOLVER_MAX_CONTACTS];
+    float pairTimes[CONTACT_SOLVER_MAX_CONTACTS];
+    Vector2 stepStart[BALL_CAPACITY];
+    Vector2 contactExit[BALL_CAPACITY];
+    Vector2 motion[BALL_CAPACITY];
+    float times[BALL_CAPACITY];
+    bool changed[BALL_CAPACITY];
+    bool pushed[BALL_CAPACITY];
+    bool hit[BALL_CAPACITY];
+    int candidates[BALL_CAPACITY];
+
+    beginContactSolverStep( &gw->contactSolver );
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        stepStart[i] = (Vector2) { bb->px[i], bb->py[i] };
+        times[i] = 0.0f;
+        changed[i] = true;
+        hit[i] = false;
+    }
+
+    for ( int n = 0; n < MAX_BALL_CONTACTS_PER_STEP; n++ ) {
+
+        int first = -1;
+
+        // ties go to the pair found first, so the order is deterministic
+        for ( int i = 0; i < bp->pairCount; i++ ) {
+
+            BallPair *p = &bp->pairs[i];
+
+            if ( changed[p->a] || changed[p->b] ) {
+                CollisionResult collision = ballBallSweep( bb, p->a, p->b );
+                pairTimes[i] = collision.hasCollision ? times[p->a] + ( 1.0f - times[p->a] ) * collision.t : 2.0f;
+            }
+
+            if ( pairTimes[i] <= 1.0f && ( first == -1 || pairTimes[i] < pairTimes[first] ) ) {
+                first = i;
+            }
+
+        }
+
+        if ( first == -1 ) {
+            break;
+        }
+
+        // the balls of the island go to the time of the contact; the ones
+        // at rest are there already and may be pushed by the group
+        BallPair pair = bp->pairs[first];
+        float now = pairTimes[first];
+        int island = bp->islands[pair.a];
+        int candidateCount = 0;
+
+        for ( int i = 0; i < gw->ballCount; i++ ) {
+            changed[i] = pushed[i] = false;
+            if ( bp->islands[i] == island ) {
+                moveBallToTime( bb, i, times[i], now );
+                times[i] = now;
+                motion[i] = (Vector2) { bb->x[i] - bb->px[i], bb->y[i] - bb->py[i] };
+                bb->x[i] = bb->px[i];
+                bb->y[i] = bb->py[i];
+                candidates[candidateCount++] = i;
+            } else if ( bp->islands[i] == -1 && !awake[i] && !bb->pocketed[i] ) {
+                motion[i] = (Vector2) { 0 };
+                candidates[candidateCount++] = i;
+            }
+        }
+
+        int contactCount = solveBallContacts( &gw->contactSolver, bb, candidates, candidateCount, pair.a, pair.b, contacts );
+        float remaining = delta * ( 1.0f - now );
+
+        for ( int i = 0; i < contactCount; i++ ) {
+            BallContact *c = &contacts[i];
+            changed[c->a] = changed[c->b] = true;
+            if ( c->impulse > 0.0f ) {
+                registerBallHit( gw, c->a, c->b, c->impulse );
+                motion[c->a] = (Vector2) { bb->vx[c->a] * remaining, bb->vy[c->a] * remaining };
+                motion[c->b] = (Vector2) { bb->vx[c->b] * remaining, bb->vy[c->b] * remaining };
+                hit[c->a] = hit[c->b] = true;
+                pushed[c->a] = pushed[c->b] = true;
+            }
+        }
+
+        // the balls that got an impulse run what is left of the step with the new velocities
+        for ( int i = 0; i < candidateCount; i++ ) {
+            int k = candidates[i];
+            bb->px[k] = bb->x[k];
+            bb->py[k] = bb->y[k];
+            bb->x[k] += motion[k].x;
+            bb->y[k] += motion[k].y;
+            if ( hit[k] ) {
+                contactExit[k] = (Vector2) { bb->px[k], bb->py[k] };
+            }
+        }
+
+        // a new path may reach any ball, even one at rest or of another
+        // island: it joins the island at the time of the contact
+        for ( int i = 0; i < gw->ballCount; i++ ) {
+
+            if ( !pushed[i] ) {
+                continue;
+            }
+
+            bp->islands[i] = island;
+            times[i] = now;
+
+            for ( int j = 0; j < gw->ballCount; j++ ) {
+
+                int other = bp->islands[j];
+
+                if ( j == i || bb->pocketed[j] || !sweptBoundsOverlap( bb, i, j ) ) {
+                    continue;
+                }
+
+                for ( int k = 0; other != island && k < gw->ballCount; k++ ) {
+                    if ( k == j || ( other != -1 && bp->islands[k] == other ) ) {
+                        moveBallToTime( bb, k, times[k], now );
+                        times[k] = now;
+                    }
+                }
+
+                joinBroadphaseIslands( bp, gw->ballCount, i, j );
+
+            }
+
+        }
+
+    }
+
+    // balls that changed their path may reach a cushion after the contact
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        if ( hit[i] && !bb->pocketed[i] ) {
+            bb->px[i] = contactExit[i].x;
+            bb->py[i] = contactExit[i].y;
+            collideWithCushions( gw, i );
+        }
+        bb->px[i] = stepStart[i].x;
+        bb->py[i] = stepStart[i].y;
+    }
+
+}
+
+// prevPos goes from its time to the given one, center stays at the end of the step
+static void moveBallToTime( BallBatch *bb, int i, float from, float to ) {
+    if ( to > from ) {
+        float amount = ( to - from ) / ( 1.0f - from );
+        bb->px[i] += amount * ( bb->x[i] - bb->px[i] );
+        bb->py[i] += amount * ( bb->y[i] - bb->py[i] );
+    }
+}
+
+static float fastestBallSpeed( const GameWorld *gw ) {
+
+    float fastest = 0.0f;
+
+    const BallBatch *bb = &gw->physics;
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        if ( !bb->pocketed[i] && bb->moving[i] ) {
+            fastest = fmaxf( fastest, Vector2Length( (Vector2) { bb->vx[i], bb->vy[i] } ) );
+        }
+    }
+
+    return fastest;
+
+}
+
+// whether the ball comes closer than reach to any cushion edge
+static bool reachesCushion( GameWorld *gw, Vector2 center, float radius, float reach ) {
+
+    for ( int i = 0; i < 6; i++ ) {
+
+        Cushion *c = &gw->cushions[i];
+
+        for ( int j = 0; j < 4; j++ ) {
+            Vector2 toCenter = Vector2Subtract( center, c->vertices[j] );
+            float projection = Clamp( Vector2DotProduct( toCenter, c->edgeDirections[j] ), 0.0f, c->edgeLengths[j] );
+            Vector2 closest = Vector2Add( c->vertices[j], Vector2Scale( c->edgeDirections[j], projection ) );
+            if ( Vector2Distance( center, closest ) - radius <= reach ) {
+                return true;
+            }
+        }
+
+    }
+
+    return false;
+
+}
+
+// wakes up a sleeping ball that got hit
+static void registerBallHit( GameWorld *gw, int a, int b, float impulse ) {
+
+    BallBatch *bb = &gw->physics;
+
+    pushSimulationEvent( &gw->events, (SimulationEvent) {
+        .type = SIMULATION_EVENT_BALL_HIT,
+        .a = (uint8_t) a,
+        .b = (uint8_t) b,
+        .value = impulse
+    });
+
+    if ( bb->vx[a] != 0.0f || bb->vy[a] != 0.0f ) {
+        bb->moving[a] = -1;
+    }
+    if ( bb->vx[b] != 0.0f || bb->vy[b] != 0.0f ) {
+        bb->moving[b] = -1;
+    }
+
+}
+
+static void pushBallEvent( GameWorld *gw, SimulationEventType type, int i, float value ) {
+    pushSimulationEvent( &gw->events, (SimulationEvent) {
+        .type = type,
+        .a = (uint8_t) i,
+        .value = value
+    });
+}
+
+static CueStick *rebaseCueStick( GameWorld *dst, const GameWorld *src, const CueStick *cs ) {
+    if ( cs == &src->cueStickP1 ) {
+        return &dst->cueStickP1;
+    } else if ( cs == &src->cueStickP2 ) {
+        return &dst->cueStickP2;
+    }
+    return NULL;
+}
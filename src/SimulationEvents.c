@@ -0,0 +1,67 @@
+/**
+ * @file SimulationEvents.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Simulation event ring implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SimulationEvents.h"
+#include "Types.h"
+
+void setupSimulationEvents( SimulationEventBuffer *events ) {
+    events->written = 0;
+    events->stepStart = 0;
+    events->dropped = 0;
+}
+
+void pushSimulationEvent( SimulationEventBuffer *events, SimulationEvent event ) {
+
+    if ( event.type == SIMULATION_EVENT_BALL_HIT ) {
+        for ( uint32_t i = events->stepStart; i < events->written; i++ ) {
+            SimulationEvent *e = &events->events[i % SIMULATION_EVENT_CAPACITY];
+            if ( e->type == SIMULATION_EVENT_BALL_HIT && e->a == event.a && e->b == event.b ) {
+                e->value += event.value;
+                return;
+            }
+        }
+    }
+
+    // a step of the 22 balls of snooker pushes at most 231 hits, 264 cushion
+    // hits, 22 pocketed and 22 stopped balls, so this only guards the events
+    // the rules still need; a drop is counted to be seen in the debug info
+    if ( events->written - events->stepStart >= SIMULATION_EVENT_CAPACITY ) {
+        events->dropped++;
+        return;
+    }
+
+    events->events[events->written % SIMULATION_EVENT_CAPACITY] = event;
+    events->written++;
+
+}
+
+void endSimulationEventStep( SimulationEventBuffer *events ) {
+    events->stepStart = events->written;
+}
+
+bool readSimulationEvent( const SimulationEventBuffer *events, uint32_t *cursor, SimulationEvent *event ) {
+
+    if ( *cursor > events->written ) {
+        *cursor = events->written;
+    } else if ( events->written - *cursor > SIMULATION_EVENT_CAPACITY ) {
+        *cursor = events->written - SIMULATION_EVENT_CAPACITY;
+    }
+
+    if ( *cursor == events->written ) {
+        return false;
+    }
+
+    *event = events->events[*cursor % SIMULATION_EVENT_CAPACITY];
+    ( *cursor )++;
+
+    return true;
+
+}
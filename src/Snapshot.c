@@ -0,0 +1,113 @@
+/**
+ * @file Snapshot.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Game snapshot implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "raylib/raylib.h"
+
+#include "BallBatch.h"
+#include "CommonMacros.h"
+#include "Snapshot.h"
+#include "Types.h"
+
+void captureGameSnapshot( GameSnapshot *snapshot, const GameWorld *gw ) {
+
+    snapshot->ballCount = gw->ballCount;
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        snapshot->centers[i] = gw->balls[i].center;
+        snapshot->pocketed[i] = gw->balls[i].pocketed;
+        snapshot->numbers[i] = gw->balls[i].number;
+        snapshot->striped[i] = gw->balls[i].striped;
+        snapshot->colors[i] = gw->balls[i].color;
+    }
+
+    const CueStick *cueSticks[] = { &gw->cueStickP1, &gw->cueStickP2 };
+
+    for ( int i = 0; i < 2; i++ ) {
+        snapshot->groups[i] = cueSticks[i]->group;
+        snapshot->cueStickPocketed[i] = cueSticks[i]->pocketed;
+        snapshot->scores[i] = cueSticks[i]->score;
+    }
+
+    snapshot->ballsOn = gw->ballsOn;
+    snapshot->currentCueStick = cueStickToIndex( gw, gw->currentCueStick );
+    snapshot->lastCueStick = cueStickToIndex( gw, gw->lastCueStick );
+    snapshot->winnerCueStick = cueStickToIndex( gw, gw->winnerCueStick );
+    snapshot->state = gw->state;
+    snapshot->pocketedCount = gw->pocketedCount;
+    memcpy( snapshot->pocketedBalls, gw->pocketedBalls, sizeof( snapshot->pocketedBalls ) );
+    snapshot->statistics = gw->statistics;
+    snapshot->rngState = gw->rng.state;
+
+}
+
+void restoreGameSnapshot( GameWorld *gw, const GameSnapshot *snapshot ) {
+
+    assert( snapshot->ballCount == gw->ballCount );
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        Ball *b = &gw->balls[i];
+        b->center = snapshot->centers[i];
+        b->prevPos = b->center;
+        b->vel = (Vector2) { 0 };
+        b->spin = (Vector2) { 0 };
+        b->pocketed = snapshot->pocketed[i];
+        b->moving = false;
+        b->number = snapshot->numbers[i];
+        b->striped = snapshot->striped[i];
+        b->color = snapshot->colors[i];
+    }
+
+    loadBallBatch( &gw->physics, gw->balls, gw->ballCount );
+
+    CueStick *cueSticks[] = { &gw->cueStickP1, &gw->cueStickP2 };
+
+    for ( int i = 0; i < 2; i++ ) {
+        cueSticks[i]->group = snapshot->groups[i];
+        cueSticks[i]->pocketed = snapshot->cueStickPocketed[i];
+        cueSticks[i]->score = snapshot->scores[i];
+        cueSticks[i]->state = CUE_STICK_STATE_READY;
+    }
+
+    gw->ballsOn = snapshot->ballsOn;
+    gw->currentCueStick = indexToCueStick( gw, snapshot->currentCueStick );
+    gw->lastCueStick = indexToCueStick( gw, snapshot->lastCueStick );
+    gw->winnerCueStick = indexToCueStick( gw, snapshot->winnerCueStick );
+    gw->currentCueStick->target = gw->cueBall->center;
+    gw->state = snapshot->state;
+    gw->ballsState = GAME_STATE_BALLS_STOPPED;
+    gw->pocketedCount = snapshot->pocketedCount;
+    memcpy( gw->pocketedBalls, snapshot->pocketedBalls, sizeof( gw->pocketedBalls ) );
+    gw->statistics = snapshot->statistics;
+    gw->rng.state = snapshot->rngState;
+    gw->applyRules = false;
+    gw->clock.accumulator = 0.0f;
+
+}
+
+int cueStickToIndex( const GameWorld *gw, const CueStick *cs ) {
+    if ( cs == &gw->cueStickP1 ) {
+        return 0;
+    } else if ( cs == &gw->cueStickP2 ) {
+        return 1;
+    }
+    return -1;
+}
+
+CueStick *indexToCueStick( GameWorld *gw, int index ) {
+    if ( index == 0 ) {
+        return &gw->cueStickP1;
+    } else if ( index == 1 ) {
+        return &gw->cueStickP2;
+    }
+    return NULL;
+}
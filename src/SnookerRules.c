@@ -0,0 +1,375 @@
+/**
+ * @file SnookerRules.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Snooker rules implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+
+#include "BallMask.h"
+#include "CommonMacros.h"
+#include "GameRules.h"
+#include "SnookerRules.h"
+#include "Types.h"
+
+// reds are the balls 1 to 15, the colours 16 (yellow) to 21 (black)
+#define REDS_MASK ( (BallMask) 0x0000FFFE )
+#define COLOURS_MASK ( (BallMask) 0x003F0000 )
+#define BLACK_MASK BALL_MASK( 21 )
+#define FIRST_COLOUR 16
+#define COLOUR_COUNT 6
+
+// proportions of a 12 foot table, in table widths
+#define BAULK_LINE 0.2065f
+#define D_RADIUS 0.0818f
+#define BLACK_SPOT 0.0908f
+
+static const Color SNOOKER_RED = { 190, 20, 20, 255 };
+static const Color SNOOKER_COLOURS[COLOUR_COUNT] = {
+    { 255, 215, 0, 255 },     // yellow
+    { 0, 140, 60, 255 },      // green
+    { 120, 70, 20, 255 },     // brown
+    { 20, 70, 200, 255 },     // blue
+    { 255, 120, 170, 255 },   // pink
+    { 10, 10, 10, 255 }       // black
+};
+
+static int foulPenalty( GameWorld *gw );
+static int maskValue( BallMask mask );
+static BallMask nextBallsOn( GameWorld *gw, BallMask on, bool foul );
+static void respotColours( GameWorld *gw, BallMask colours );
+static void endFrame( GameWorld *gw );
+static Vector2 colourSpot( const GameWorld *gw, int number );
+static bool isSpotFree( const GameWorld *gw, const Ball *ball, Vector2 spot );
+static Ball *findBall( GameWorld *gw, int number );
+static void rackSnooker( GameWorld *gw );
+
+void applyRulesSnooker( GameWorld *gw ) {
+
+    trace( "applying rules:" );
+
+    BallMask on = gw->ballsOn;
+    BallMask potted = gw->statistics.pocketed;
+    int penalty = foulPenalty( gw );
+    bool foul = penalty > 0;
+
+    if ( foul ) {
+        // finishShot already gave the turn to the opponent
+        gw->currentCueStick->score += penalty;
+        trace( "    foul - %d points to the opponent", penalty );
+    } else if ( potted != 0 ) {
+        gw->lastCueStick->score += countBallMask( potted & REDS_MASK ) + maskValue( potted & COLOURS_MASK );
+        gw->currentCueStick = gw->lastCueStick;
+        trace( "    balls potted - turn continues" );
+    } else {
+        trace( "    nothing potted - turn ends" );
+    }
+
+    // the colours come back while reds are left, and always after a foul;
+    // a colour is down for good only when it was the one ball on
+    if ( foul || countBallMask( on ) > 1 || ( on & REDS_MASK ) ) {
+        respotColours( gw, potted & COLOURS_MASK );
+    }
+
+    gw->ballsOn = nextBallsOn( gw, on, foul );
+    gw->state = gw->statistics.cueBallPocketed ? GAME_STATE_BALL_IN_HAND : GAME_STATE_PLAYING;
+
+    // a foul on the last black ends the frame as well
+    if ( ( tableBallMask( gw->balls, gw->ballCount ) & ~CUE_BALL_MASK ) == 0 || ( foul && on == BLACK_MASK ) ) {
+        endFrame( gw );
+    }
+
+}
+
+// the pocketed balls go to the rail of the shooter, the colours leave it
+// again when they are respotted
+void onEventSnooker( GameWorld *gw, const SimulationEvent *event ) {
+    if ( event->type == SIMULATION_EVENT_BALL_POCKETED && &gw->balls[event->a] != gw->cueBall ) {
+        gw->currentCueStick->pocketed |= BALL_MASK( gw->balls[event->a].number );
+    }
+}
+
+BallMask legalTargetsSnooker( const GameWorld *gw ) {
+    return gw->ballsOn;
+}
+
+int snookerBallValue( int number ) {
+    if ( number <= 0 ) {
+        return 0;
+    } else if ( number < FIRST_COLOUR ) {
+        return 1;
+    }
+    return number - FIRST_COLOUR + 2;
+}
+
+float snookerBaulkLine( const GameWorld *gw ) {
+    return gw->boundarie.x + gw->boundarie.width * BAULK_LINE;
+}
+
+float snookerDRadius( const GameWorld *gw ) {
+    return gw->boundarie.width * D_RADIUS;
+}
+
+void setupSnooker( GameWorld *gw ) {
+
+    setupTable( gw, GAME_RULES_SNOOKER );
+
+    for ( int i = 1; i < gw->ballCount; i++ ) {
+        Ball *b = &gw->balls[i];
+        b->color = i < FIRST_COLOUR ? SNOOKER_RED : SNOOKER_COLOURS[i - FIRST_COLOUR];
+        b->striped = false;
+        b->plain = true;
+    }
+
+    rackSnooker( gw );
+    gw->ballsOn = REDS_MASK;
+
+    // the break is a shot like any other
+    gw->state = GAME_STATE_PLAYING;
+
+}
+
+/**
+ * Zero for a legal shot. The penalty is the value of the ball on, of the
+ * ball hit first or of the highest ball potted, but never less than 4.
+ */
+static int foulPenalty( GameWorld *gw ) {
+
+    TurnStatistics *s = &gw->statistics;
+    BallMask on = gw->ballsOn;
+    BallMask first = BALL_MASK( s->cueBallFirstHitNumber );
+    int penalty = 4;
+    bool foul = false;
+
+    // a single ball on is the one the shot was for
+    if ( countBallMask( on ) == 1 && maskValue( on ) > penalty ) {
+        penalty = maskValue( on );
+    }
+
+    if ( s->cueBallHits == 0 ) {
+        trace( "    foul: didn't hit anything" );
+        return penalty;
+    }
+
+    if ( maskValue( first ) > penalty ) {
+        penalty = maskValue( first );
+    }
+
+    if ( maskValue( s->pocketed ) > penalty ) {
+        penalty = maskValue( s->pocketed );
+    }
+
+    if ( s->cueBallPocketed ) {
+        trace( "    foul: cue ball pocketed" );
+        foul = true;
+    }
+
+    if ( !( on & first ) ) {
+        trace( "    foul: didn't hit a ball on first" );
+        foul = true;
+    }
+
+    if ( s->pocketed & ~on ) {
+        trace( "    foul: potted a ball not on" );
+        foul = true;
+    }
+
+    // after a red only one colour may go down
+    if ( ( on & COLOURS_MASK ) && countBallMask( s->pocketed ) > 1 ) {
+        trace( "    foul: potted more than one colour" );
+        foul = true;
+    }
+
+    return foul ? penalty : 0;
+
+}
+
+// a red is worth 1, a set of colours the highest of them
+static int maskValue( BallMask mask ) {
+    if ( mask & COLOURS_MASK ) {
+        return snookerBallValue( 31 - __builtin_clz( mask & COLOURS_MASK ) );
+    }
+    return ( mask & REDS_MASK ) ? 1 : 0;
+}
+
+/**
+ * A red potted legally is followed by any colour. Otherwise the reds are
+ * on while there are any, then the colours from the lowest to the black.
+ */
+static BallMask nextBallsOn( GameWorld *gw, BallMask on, bool foul ) {
+
+    BallMask table = tableBallMask( gw->balls, gw->ballCount );
+
+    if ( !foul && ( on & REDS_MASK ) && ( gw->statistics.pocketed & REDS_MASK ) ) {
+        return COLOURS_MASK;
+    }
+
+    if ( table & REDS_MASK ) {
+        return table & REDS_MASK;
+    }
+
+    return lowestBallMask( table & COLOURS_MASK );
+
+}
+
+/**
+ * Back on their own spots, the highest first, or on the highest spot free
+ * when it is covered. With every spot covered the ball goes behind its own
+ * spot, towards the top cushion.
+ */
+static void respotColours( GameWorld *gw, BallMask colours ) {
+
+    for ( int number = FIRST_COLOUR + COLOUR_COUNT - 1; number >= FIRST_COLOUR; number-- ) {
+
+        if ( !( colours & BALL_MASK( number ) ) ) {
+            continue;
+        }
+
+        Ball *ball = findBall( gw, number );
+        Vector2 spot = colourSpot( gw, number );
+
+        for ( int other = FIRST_COLOUR + COLOUR_COUNT - 1; !isSpotFree( gw, ball, spot ) && other >= FIRST_COLOUR; other-- ) {
+            spot = colourSpot( gw, other );
+        }
+
+        // every spot is taken: as near as possible to its own spot toward
+        // the top cushion or, with no room there, toward the baulk cushion
+        if ( !isSpotFree( gw, ball, spot ) ) {
+
+            Vector2 own = colourSpot( gw, number );
+            float top = gw->boundarie.x + gw->boundarie.width - ball->radius;
+            float baulk = gw->boundarie.x + ball->radius;
+
+            spot = own;
+            while ( spot.x <= top && !isSpotFree( gw, ball, spot ) ) {
+                spot.x += 1.0f;
+            }
+
+            if ( spot.x > top ) {
+                spot = own;
+                while ( spot.x >= baulk && !isSpotFree( gw, ball, spot ) ) {
+                    spot.x -= 1.0f;
+                }
+                if ( spot.x < baulk ) {
+                    spot = own;
+                }
+            }
+
+        }
+
+        ball->center = spot;
+        ball->prevPos = spot;
+        ball->vel = (Vector2) { 0, 0 };
+        ball->spin = (Vector2) { 0, 0 };
+        ball->moving = false;
+        ball->pocketed = false;
+
+        gw->lastCueStick->pocketed &= (BallMask) ~BALL_MASK( number );
+
+        // off the rail of the pocketed balls
+        int count = 0;
+        for ( int i = 0; i < gw->pocketedCount; i++ ) {
+            if ( gw->pocketedBalls[i] != number ) {
+                gw->pocketedBalls[count++] = gw->pocketedBalls[i];
+            }
+        }
+        gw->pocketedCount = count;
+
+    }
+
+}
+
+// the highest score wins, a tie is played off on the black
+static void endFrame( GameWorld *gw ) {
+
+    CueStick *p1 = &gw->cueStickP1;
+    CueStick *p2 = &gw->cueStickP2;
+
+    if ( p1->score == p2->score ) {
+        trace( "    tie - black respotted" );
+        respotColours( gw, BLACK_MASK );
+        gw->ballsOn = BLACK_MASK;
+        return;
+    }
+
+    gw->winnerCueStick = p1->score > p2->score ? p1 : p2;
+    gw->state = GAME_STATE_GAME_OVER;
+    trace( "    frame over - %d x %d", p1->score, p2->score );
+
+}
+
+static Vector2 colourSpot( const GameWorld *gw, int number ) {
+
+    float baulk = snookerBaulkLine( gw );
+    float d = snookerDRadius( gw );
+    float y = gw->boundarie.y + gw->boundarie.height / 2;
+    float w = gw->boundarie.width;
+
+    switch ( number ) {
+        case FIRST_COLOUR: return (Vector2) { baulk, y + d };
+        case FIRST_COLOUR + 1: return (Vector2) { baulk, y - d };
+        case FIRST_COLOUR + 2: return (Vector2) { baulk, y };
+        case FIRST_COLOUR + 3: return (Vector2) { gw->boundarie.x + w / 2, y };
+        case FIRST_COLOUR + 4: return (Vector2) { gw->boundarie.x + w * 0.75f, y };
+        default: return (Vector2) { gw->boundarie.x + w - w * BLACK_SPOT, y };
+    }
+
+}
+
+static bool isSpotFree( const GameWorld *gw, const Ball *ball, Vector2 spot ) {
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        const Ball *b = &gw->balls[i];
+        if ( b != ball && !b->pocketed && Vector2Distance( b->center, spot ) < b->radius + ball->radius ) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+static Ball *findBall( GameWorld *gw, int number ) {
+
+    for ( int i = 1; i < gw->ballCount; i++ ) {
+        if ( gw->balls[i].number == number ) {
+            return &gw->balls[i];
+        }
+    }
+
+    return NULL;
+
+}
+
+// the colours on their spots and the reds in a triangle right behind the
+// pink, pointing at it
+static void rackSnooker( GameWorld *gw ) {
+
+    for ( int i = FIRST_COLOUR; i < gw->ballCount; i++ ) {
+        gw->balls[i].center = colourSpot( gw, i );
+        gw->balls[i].prevPos = gw->balls[i].center;
+    }
+
+    Vector2 pink = colourSpot( gw, FIRST_COLOUR + 4 );
+    float radius = gw->cueBall->radius;
+    float spacing = radius * 2 + 0.5f;
+    int k = 1;
+
+    for ( int i = 0; i < 5; i++ ) {
+        for ( int j = 0; j <= i; j++ ) {
+            Ball *b = &gw->balls[k++];
+            b->center = (Vector2) {
+                pink.x + radius * 2 + 1.0f + spacing * 0.866f * i,
+                pink.y - spacing / 2 * i + spacing * j
+            };
+            b->prevPos = b->center;
+        }
+    }
+
+}
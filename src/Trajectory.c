@@ -0,0 +1,268 @@
+/**
+ * @file Trajectory.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Aiming trajectory implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "raylib/raylib.h"
+#include "raylib/raymath.h"
+
+#include "BallMotion.h"
+#include "CommonMacros.h"
+#include "Trajectory.h"
+#include "Types.h"
+
+typedef struct PathHit {
+    int ballIndex;              // first ball touched, -1 if none
+    Vector2 center;             // center of the moving ball at the end
+    Vector2 direction;          // direction it was moving at the end
+    float speed;                // speed left at the end
+} PathHit;
+
+static PathHit castPath( const GameWorld *gw, const Ball *moving, Vector2 start, Vector2 direction, float speed, int ignoredBall, TrajectoryPath *path );
+static float castAgainstBalls( const GameWorld *gw, const Ball *moving, Vector2 start, Vector2 direction, int ignoredBall, int *ballIndex );
+static float castAgainstCushions( const GameWorld *gw, float radius, Vector2 start, Vector2 direction, Vector2 *normal );
+static float castAgainstPockets( const GameWorld *gw, float radius, Vector2 start, Vector2 direction );
+static bool isCacheValid( const TrajectoryCache *cache, const GameWorld *gw );
+
+TrajectoryPrediction predictTrajectory( const GameWorld *gw ) {
+
+    TrajectoryPrediction pred = { 0 };
+    const CueStick *cs = gw->currentCueStick;
+    const Ball *cueBall = gw->cueBall;
+
+    float angle = DEG2RAD * cs->angle;
+    Vector2 direction = { cosf( angle ), sinf( angle ) };
+
+    PathHit cueHit = castPath( gw, cueBall, cueBall->center, direction, cs->power, 0, &pred.cueBallPath );
+    pred.cueBallStopPoint = cueHit.center;
+
+    if ( cueHit.ballIndex == -1 ) {
+        pred.ballIndex = -1;
+        return pred;
+    }
+
+    const Ball *target = &gw->balls[cueHit.ballIndex];
+    Vector2 impactDirection = Vector2Normalize( Vector2Subtract( target->center, cueHit.center ) );
+
+    pred.willHitBall = true;
+    pred.ballIndex = cueHit.ballIndex;
+    pred.hitPoint = Vector2Subtract( target->center, Vector2Scale( impactDirection, target->radius ) );
+    pred.targetBallDirection = impactDirection;
+
+    // equal masses: the target takes the velocity along the line of centers
+    float cosine = Vector2DotProduct( cueHit.direction, impactDirection );
+    pred.targetBallSpeed = cueHit.speed * fmaxf( cosine, 0.0f );
+
+    castPath( gw, target, target->center, impactDirection, pred.targetBallSpeed, cueHit.ballIndex, &pred.targetBallPath );
+
+    return pred;
+
+}
+
+const TrajectoryPrediction *getCachedTrajectory( TrajectoryCache *cache, const GameWorld *gw ) {
+
+    if ( !isCacheValid( cache, gw ) ) {
+
+        const CueStick *cs = gw->currentCueStick;
+
+        cache->prediction = predictTrajectory( gw );
+        cache->angle = cs->angle;
+        cache->power = cs->power;
+        cache->hitPoint = cs->hitPoint;
+
+        for ( int i = 0; i < gw->ballCount; i++ ) {
+            cache->centers[i] = gw->balls[i].center;
+            cache->pocketed[i] = gw->balls[i].pocketed;
+        }
+
+        cache->valid = true;
+
+    }
+
+    return &cache->prediction;
+
+}
+
+void invalidateTrajectoryCache( TrajectoryCache *cache ) {
+    cache->valid = false;
+}
+
+/**
+ * @brief Moves a ball from start until it touches another ball, drops in a
+ * pocket, stops or bounces TRAJECTORY_MAX_BOUNCES times. The speed falls
+ * linearly with the distance covered (see BallMotion): v(s) = v0 - k * s.
+ */
+static PathHit castPath( const GameWorld *gw, const Ball *moving, Vector2 start, Vector2 direction, float speed, int ignoredBall, TrajectoryPath *path ) {
+
+    float k = ballDecayRate( moving );
+    PathHit hit = { .ballIndex = -1 };
+
+    path->pointCount = 0;
+    path->pocketed = false;
+    path->points[path->pointCount++] = start;
+
+    for ( int bounce = 0; ; bounce++ ) {
+
+        float sStop = ballStopDistance( moving, speed );
+        int ballIndex = -1;
+        Vector2 normal = { 0 };
+
+        float sBall = castAgainstBalls( gw, moving, start, direction, ignoredBall, &ballIndex );
+        float sCushion = castAgainstCushions( gw, moving->radius, start, direction, &normal );
+        float sPocket = castAgainstPockets( gw, moving->radius, start, direction );
+        float s = fminf( fminf( sStop, sBall ), fminf( sCushion, sPocket ) );
+
+        start = Vector2Add( start, Vector2Scale( direction, s ) );
+        speed -= k * s;
+        path->points[path->pointCount++] = start;
+
+        if ( s == sBall ) {
+            hit.ballIndex = ballIndex;
+        } else if ( s == sPocket ) {
+            path->pocketed = true;
+        } else if ( s == sCushion && bounce < TRAJECTORY_MAX_BOUNCES ) {
+            float dot = Vector2DotProduct( direction, normal );
+            direction = Vector2Subtract( direction, Vector2Scale( normal, 2.0f * dot ) );
+            speed *= moving->elasticity;
+            continue;
+        }
+
+        break;
+
+    }
+
+    hit.center = start;
+    hit.direction = direction;
+    hit.speed = fmaxf( speed, 0.0f );
+
+    return hit;
+
+}
+
+static float castAgainstBalls( const GameWorld *gw, const Ball *moving, Vector2 start, Vector2 direction, int ignoredBall, int *ballIndex ) {
+
+    float sMin = INFINITY;
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+
+        const Ball *b = &gw->balls[i];
+
+        // the cue ball left its place, the target ball is the one moving
+        if ( b == moving || b == gw->cueBall || i == ignoredBall || b->pocketed ) {
+            continue;
+        }
+
+        float s = firstContactDisplacement( Vector2Subtract( b->center, start ), direction, moving->radius + b->radius );
+
+        if ( s > 0.01f && s < sMin ) {
+            sMin = s;
+            *ballIndex = i;
+        }
+
+    }
+
+    return sMin;
+
+}
+
+static float castAgainstCushions( const GameWorld *gw, float radius, Vector2 start, Vector2 direction, Vector2 *normal ) {
+
+    float sMin = INFINITY;
+
+    for ( int c = 0; c < 6; c++ ) {
+
+        const Cushion *cushion = &gw->cushions[c];
+        const Vector2 *vertices = cushion->vertices;
+
+        for ( int e = 0; e < 4; e++ ) {
+
+            Vector2 edgeNormal = cushion->edgeNormals[e];
+            float dist = Vector2DotProduct( Vector2Subtract( start, vertices[e] ), edgeNormal );
+            float approach = Vector2DotProduct( direction, edgeNormal );
+
+            // behind the edge or moving away from it
+            if ( dist < 0.0f || approach >= 0.0f ) {
+                continue;
+            }
+
+            float s = fmaxf( ( radius - dist ) / approach, 0.0f );
+
+            if ( s > 0.01f && s < sMin ) {
+                Vector2 contact = Vector2Add( start, Vector2Scale( direction, s ) );
+                float projection = Vector2DotProduct( Vector2Subtract( contact, vertices[e] ), cushion->edgeDirections[e] );
+                if ( projection >= 0.0f && projection <= cushion->edgeLengths[e] ) {
+                    sMin = s;
+                    *normal = edgeNormal;
+                }
+            }
+
+        }
+
+        for ( int v = 0; v < 4; v++ ) {
+
+            float s = firstContactDisplacement( Vector2Subtract( vertices[v], start ), direction, radius );
+
+            if ( s > 0.01f && s < sMin ) {
+                Vector2 contact = Vector2Add( start, Vector2Scale( direction, s ) );
+                sMin = s;
+                *normal = Vector2Normalize( Vector2Subtract( contact, vertices[v] ) );
+            }
+
+        }
+
+    }
+
+    return sMin;
+
+}
+
+static float castAgainstPockets( const GameWorld *gw, float radius, Vector2 start, Vector2 direction ) {
+
+    float sMin = INFINITY;
+
+    for ( int p = 0; p < 6; p++ ) {
+
+        // more than 50% of ball is inside the pocket
+        const Pocket *pocket = &gw->pockets[p];
+        float s = firstContactDisplacement( Vector2Subtract( pocket->center, start ), direction, pocket->radius - radius * 0.5f );
+
+        if ( s < sMin ) {
+            sMin = s;
+        }
+
+    }
+
+    return sMin;
+
+}
+
+static bool isCacheValid( const TrajectoryCache *cache, const GameWorld *gw ) {
+
+    const CueStick *cs = gw->currentCueStick;
+
+    if ( !cache->valid ||
+         cache->angle != cs->angle ||
+         cache->power != cs->power ||
+         cache->hitPoint.x != cs->hitPoint.x ||
+         cache->hitPoint.y != cs->hitPoint.y ) {
+        return false;
+    }
+
+    for ( int i = 0; i < gw->ballCount; i++ ) {
+        const Ball *b = &gw->balls[i];
+        if ( cache->centers[i].x != b->center.x ||
+             cache->centers[i].y != b->center.y ||
+             cache->pocketed[i] != b->pocketed ) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
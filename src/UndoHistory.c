@@ -0,0 +1,126 @@
+/**
+ * @file UndoHistory.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Undo history implementation.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "raylib/raylib.h"
+
+#include "Snapshot.h"
+#include "Types.h"
+#include "UndoHistory.h"
+
+static UndoEntry *entryAt( UndoHistory *h, int index );
+static UndoEntry *appendEntry( UndoHistory *h );
+
+void setupUndoHistory( UndoHistory *h, int capacity ) {
+    if ( capacity < 2 ) {
+        capacity = 2;
+    }
+    h->entries = (UndoEntry*) malloc( sizeof( UndoEntry ) * capacity );
+    h->capacity = h->entries != NULL ? capacity : 0;
+    h->first = 0;
+    h->count = 0;
+    h->cursor = 0;
+}
+
+void destroyUndoHistory( UndoHistory *h ) {
+    free( h->entries );
+    h->entries = NULL;
+    h->capacity = 0;
+    clearUndoHistory( h );
+}
+
+void clearUndoHistory( UndoHistory *h ) {
+    h->first = 0;
+    h->count = 0;
+    h->cursor = 0;
+}
+
+void pushUndoHistory( UndoHistory *h, const GameWorld *gw, int replayLength ) {
+
+    discardRedoHistory( h );
+    UndoEntry *e = appendEntry( h );
+
+    if ( e != NULL ) {
+        captureGameSnapshot( &e->snapshot, gw );
+        e->replayLength = replayLength;
+        h->cursor = h->count;
+    }
+
+}
+
+bool undoGameWorld( UndoHistory *h, GameWorld *gw, int *replayLength ) {
+
+    if ( h->cursor == 0 ) {
+        return false;
+    }
+
+    // the present is kept as the first shot to redo
+    if ( h->cursor == h->count ) {
+        UndoEntry *e = appendEntry( h );
+        if ( e == NULL || h->cursor == 0 ) {
+            return false;
+        }
+        captureGameSnapshot( &e->snapshot, gw );
+        e->replayLength = *replayLength;
+    }
+
+    h->cursor--;
+    UndoEntry *e = entryAt( h, h->cursor );
+    restoreGameSnapshot( gw, &e->snapshot );
+    *replayLength = e->replayLength;
+
+    return true;
+
+}
+
+bool redoGameWorld( UndoHistory *h, GameWorld *gw, int *replayLength ) {
+
+    if ( h->cursor + 1 >= h->count ) {
+        return false;
+    }
+
+    h->cursor++;
+    UndoEntry *e = entryAt( h, h->cursor );
+    restoreGameSnapshot( gw, &e->snapshot );
+    *replayLength = e->replayLength;
+
+    return true;
+
+}
+
+void discardRedoHistory( UndoHistory *h ) {
+    h->count = h->cursor;
+}
+
+static UndoEntry *entryAt( UndoHistory *h, int index ) {
+    return &h->entries[( h->first + index ) % h->capacity];
+}
+
+/**
+ * @brief Room for one more entry at the end, dropping the oldest one when
+ * the ring is full.
+ */
+static UndoEntry *appendEntry( UndoHistory *h ) {
+
+    if ( h->capacity == 0 ) {
+        return NULL;
+    }
+
+    if ( h->count == h->capacity ) {
+        h->first = ( h->first + 1 ) % h->capacity;
+        h->count--;
+        if ( h->cursor > 0 ) {
+            h->cursor--;
+        }
+    }
+
+    return entryAt( h, h->count++ );
+
+}
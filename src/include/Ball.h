@@ -10,14 +10,15 @@
 
 #include "Types.h"
 
-void updateBall( Ball *b, float delta );
 void drawBall( Ball *b );
+void drawBallAt( const Ball *b, Vector2 center, float radius, Color tint );
 
-void resolveCollisionBallBall( Ball *b1, Ball *b2 );
-CollisionResult ballSegmentCollision( Ball *b, Vector2 segStart, Vector2 segEnd );
-CollisionResult ballPointSweep( Ball *b, Vector2 point );
-CollisionResult ballConvexCollision( Ball *b, Vector2* vertices, int numVertices );
-CollisionResult ballCushionCollision( Ball *b, Cushion *c );
+// sweeps of the balls of the physics state, from the start of the step to where they are
+CollisionResult ballSegmentCollision( const BallBatch *bb, int i, Vector2 segStart, Vector2 segEnd );
+CollisionResult ballPointSweep( const BallBatch *bb, int i, Vector2 point );
+CollisionResult ballBallSweep( const BallBatch *bb, int a, int b );
+CollisionResult ballConvexCollision( const BallBatch *bb, int i, Vector2* vertices, int numVertices );
+CollisionResult ballCushionCollision( const BallBatch *bb, int i, Cushion *c );
 
 void performDefaultBallPositioning( Ball *balls, int radius, Rectangle boundarie );
 void performTestBallPositioning( Ball *balls, int radius, Rectangle boundarie );
\ No newline at end of file
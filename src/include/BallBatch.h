@@ -0,0 +1,43 @@
+/**
+ * @file BallBatch.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Structure of arrays ball state function declarations. The
+ * BallBatch of the world is the physics state of the balls and lives
+ * across steps; the Ball structs are its view, refreshed from it for
+ * drawing and the rules and loaded into it when something else than the
+ * physics places the balls.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+/**
+ * @brief Takes position, velocity, spin, radius and flags of the count
+ * balls as the state of the batch. The lanes past the last ball up to the
+ * end of its vector are cleared.
+ */
+void loadBallBatch( BallBatch *bb, const Ball *balls, int count );
+
+/**
+ * @brief Refreshes position, velocity, spin and flags of the count balls
+ * from the batch.
+ */
+void storeBallBatch( const BallBatch *bb, Ball *balls, int count );
+
+/**
+ * @brief Ball index of balls with the state it has in the batch, for the
+ * functions that take a Ball.
+ */
+Ball ballFromBatch( const BallBatch *bb, const Ball *balls, int index );
+
+/**
+ * @brief Integrates the positions of the moving balls among the first
+ * count, applies the velocity and spin decay of one step and stops the
+ * ones slower than BALL_STOP_SPEED, 8 (AVX), 4 (SSE2) or 1 ball at a time.
+ * The balls that don't move are left as they are. The only integration of
+ * the simulation.
+ */
+void integrateBallBatch( BallBatch *bb, int count, float delta, float velDecay, float spinDecay );
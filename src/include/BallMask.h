@@ -0,0 +1,50 @@
+/**
+ * @file BallMask.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Ball set function declarations. A set of balls is a 32 bit mask
+ * with the bit n for the ball numbered n (the cue ball is 0), so the rules
+ * count and compare sets with a few integer operations.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+#define BALL_MASK( number ) ( (BallMask) ( 1u << ( number ) ) )
+#define CUE_BALL_MASK BALL_MASK( 0 )
+#define BALL_8_MASK BALL_MASK( 8 )
+#define SOLID_BALLS_MASK ( (BallMask) 0x00FE )      // 1 to 7
+#define STRIPED_BALLS_MASK ( (BallMask) 0xFE00 )    // 9 to 15
+
+/**
+ * @brief How many balls are in the set.
+ */
+int countBallMask( BallMask mask );
+
+/**
+ * @brief The balls of a group, none for an undefined group.
+ */
+BallMask groupBallMask( BallGroup group );
+
+/**
+ * @brief The balls of the other group, none for an undefined group.
+ */
+BallMask opponentGroupBallMask( BallGroup group );
+
+/**
+ * @brief The balls of count that are not pocketed.
+ */
+BallMask tableBallMask( const Ball *balls, int count );
+
+/**
+ * @brief Writes the numbers of the balls in the set to numbers, from the
+ * lowest, and returns how many there are.
+ */
+int ballMaskNumbers( BallMask mask, int *numbers );
+
+/**
+ * @brief The lowest numbered ball of the set alone, none for an empty set.
+ */
+BallMask lowestBallMask( BallMask mask );
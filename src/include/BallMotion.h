@@ -0,0 +1,69 @@
+/**
+ * @file BallMotion.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Analytic motion of a ball rolling free, only slowed down by the
+ * friction, function declarations. The velocity decays as v0 * e^(-kt), so
+ * the displacement after t seconds is v0 * s(t), with
+ * s(t) = ( 1 - e^(-kt) ) / k, and the speed falls linearly with the distance
+ * covered. Where the ball is at any time, when it stops and where it rests
+ * are one expression away, with no stepping.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+/**
+ * @brief Velocity decay rate k of the ball, per second.
+ */
+float ballDecayRate( const Ball *b );
+
+/**
+ * @brief Spin decay rate, per second. The same for every ball.
+ */
+float ballSpinDecayRate( void );
+
+/**
+ * @brief Seconds until the ball slows down to BALL_STOP_SPEED and stops.
+ * Zero for a ball already at rest.
+ */
+float ballTimeToStop( const Ball *b );
+
+/**
+ * @brief Displacement factor s left until the ball stops: it rests at
+ * center + vel * s.
+ */
+float ballStopDisplacement( const Ball *b );
+
+/**
+ * @brief Distance covered until the stop by a ball with the friction of b
+ * rolling at speed.
+ */
+float ballStopDistance( const Ball *b, float speed );
+
+/**
+ * @brief Seconds the ball takes to cover the displacement factor s, the
+ * inverse of s(t). Only meaningful up to ballStopDisplacement.
+ */
+float ballTimeForDisplacement( const Ball *b, float s );
+
+/**
+ * @brief Where the ball comes to rest.
+ */
+Vector2 ballRestPoint( const Ball *b );
+
+/**
+ * @brief Position, velocity and spin of the ball t seconds from now. After
+ * the stop the ball is at its rest point, with no velocity and no spin.
+ */
+BallMotionState ballMotionAt( const Ball *b, float t );
+
+/**
+ * @brief Smallest s >= 0 where | d0 - v * s | = distance while the distance
+ * is falling, or INFINITY. With d0 going from a ball to something and v the
+ * ball velocity (relative to the other ball, if it moves too), it is the
+ * displacement factor where they touch.
+ */
+float firstContactDisplacement( Vector2 d0, Vector2 v, float distance );
@@ -0,0 +1,71 @@
+/**
+ * @file BatchSimulation.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Multithreaded batch shot simulation function declarations. Every
+ * shot of a batch starts from the same table state, so the shots are
+ * independent and each worker thread plays them on its own copy of the
+ * world. The threads are started once and woken for each batch.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+#define BATCH_SIMULATION_MAX_THREADS 64
+
+/**
+ * @brief Number of processors available to the process (at least 1).
+ */
+int getProcessorCount( void );
+
+/**
+ * @brief Plays the n shots from the state of gw, which is left untouched,
+ * and writes the result of shots[i] to outcomes[i]. The shots are spread
+ * over one thread per processor, kept alive between batches. If threads
+ * can't be created, the shots are played on the calling thread. The
+ * outcomes are the same either way. A shot that could not be played for
+ * lack of memory has its outcome marked as not simulated.
+ */
+void simulateShotsBatch( const GameWorld *gw, const ShotParams *shots, int n, ShotOutcome *outcomes );
+
+/**
+ * @brief Same as simulateShotsBatch, with at most threadCount threads,
+ * started for this batch only.
+ */
+void simulateShotsBatchWithThreads( const GameWorld *gw, const ShotParams *shots, int n, ShotOutcome *outcomes, int threadCount );
+
+/**
+ * @brief Starts the worker threads, threadCount less the calling thread,
+ * which wait for batches until the simulator is destroyed. If threads can't
+ * be created, the shots are played on the calling thread.
+ */
+void setupBatchSimulator( BatchSimulator *bs, int threadCount );
+
+/**
+ * @brief Stops the worker threads and frees everything.
+ */
+void destroyBatchSimulator( BatchSimulator *bs );
+
+/**
+ * @brief Same as simulateShotsBatch, on the threads of bs, which plays one
+ * batch at a time. The shots are spread over the workers and the calling
+ * thread, which returns when all of them are played.
+ */
+void simulateShotsBatchWith( BatchSimulator *bs, const GameWorld *gw, const ShotParams *shots, int n, ShotOutcome *outcomes );
+
+/**
+ * @brief Plays one shot on gw (which is changed) and fills the outcome.
+ * Once only friction is left the balls jump to their rest points, so the
+ * rules are applied without stepping the slow end of the shot.
+ */
+void simulateShotOutcome( GameWorld *gw, const ShotParams *shot, ShotOutcome *outcome );
+
+/**
+ * @brief Same as simulateShotOutcome, played by the event driven
+ * simulation: the balls end close to where the stepper leaves them, at a
+ * small part of the cost, which is enough to screen candidates. steps
+ * holds the number of events.
+ */
+void screenShotOutcome( GameWorld *gw, const ShotParams *shot, ShotOutcome *outcome );
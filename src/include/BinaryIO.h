@@ -0,0 +1,29 @@
+/**
+ * @file BinaryIO.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Little endian binary file helpers. The values are written byte by
+ * byte, so the files are the same whatever the byte order of the machine.
+ * The read functions return false at the end of the file or on errors.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+void writeUint8( FILE *file, uint8_t value );
+void writeUint16( FILE *file, uint16_t value );
+void writeUint32( FILE *file, uint32_t value );
+void writeUint64( FILE *file, uint64_t value );
+void writeInt32( FILE *file, int32_t value );
+void writeFloat( FILE *file, float value );
+
+bool readUint8( FILE *file, uint8_t *value );
+bool readUint16( FILE *file, uint16_t *value );
+bool readUint32( FILE *file, uint32_t *value );
+bool readUint64( FILE *file, uint64_t *value );
+bool readInt32( FILE *file, int32_t *value );
+bool readFloat( FILE *file, float *value );
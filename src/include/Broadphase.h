@@ -0,0 +1,44 @@
+/**
+ * @file Broadphase.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Ball x ball broadphase function declarations. An incremental sort
+ * and sweep on x that keeps the order of the previous update, so sorting a
+ * table where few balls swap places is close to linear.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+/**
+ * @brief Resets the sweep order to the ball indexes.
+ */
+void setupBroadphase( Broadphase *bp );
+
+/**
+ * @brief Sorts the balls on the table by the left side of their swept
+ * bounds (from the start of the step to where they are) and fills the list
+ * of pairs whose bounds overlap. Each pair appears once, with the smallest
+ * index first.
+ */
+void updateBroadphase( Broadphase *bp, const BallBatch *bb, int count );
+
+/**
+ * @brief Drops the pairs where both balls sleep and groups the remaining
+ * balls in islands of balls that can touch each other. Balls out of every
+ * pair are left out of the islands.
+ */
+void buildBroadphaseIslands( Broadphase *bp, bool *awake, int count );
+
+/**
+ * @brief Adds the pair a x b, found after a contact changed the path of a,
+ * and moves b, with its island if it has one, into the island of a.
+ */
+void joinBroadphaseIslands( Broadphase *bp, int count, int a, int b );
+
+/**
+ * @brief Whether the swept bounds of the balls a and b overlap.
+ */
+bool sweptBoundsOverlap( const BallBatch *bb, int a, int b );
@@ -29,7 +29,28 @@
     #define trace( ... ) TraceLog( LOG_INFO, __VA_ARGS__ );
 #endif
 
-#define BALL_COUNT 15
+// room for the balls of a world, the cue ball included; how many are in
+// play is up to the game (16 in pool, 22 in snooker)
+#define BALL_CAPACITY 32
 #define BALL_RADIUS 10
 #define BALL_FRICTION 0.99f
-#define BALL_ELASTICITY 0.9f
\ No newline at end of file
+#define BALL_ELASTICITY 0.9f
+#define BALL_SPIN_DECAY 0.98f
+
+// friction and spin decay are given per 1/BALL_DECAY_RATE seconds
+#define BALL_DECAY_RATE 60.0f
+
+// slower balls stop, in pixels/second
+#define BALL_STOP_SPEED 0.5f
+
+// fixed step physics: the quality preset sets how many steps are taken
+// for each 1/PHYSICS_FRAME_RATE seconds of real time and how they adapt to
+// the speed of the balls, never more than PHYSICS_MAX_STEPS_PER_FRAME per
+// frame. Weak devices (the web build) run the low preset.
+#define PHYSICS_FRAME_RATE 60
+#define PHYSICS_MAX_STEPS_PER_FRAME 8
+#if defined( PLATFORM_WEB )
+#define PHYSICS_QUALITY SIMULATION_QUALITY_LOW
+#else
+#define PHYSICS_QUALITY SIMULATION_QUALITY_HIGH
+#endif
\ No newline at end of file
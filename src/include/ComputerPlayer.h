@@ -0,0 +1,57 @@
+/**
+ * @file ComputerPlayer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Computer opponent function declarations. The computer plays the
+ * turn of a cue stick by generating candidate shots, simulating them in
+ * parallel with simulateShotsBatch and keeping the one with the best
+ * outcome for the rules. The search runs on its own thread, so the game
+ * loop only polls it.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "Types.h"
+
+/**
+ * @brief Configures a disabled computer player with the given difficulty
+ * and starts the threads its searches simulate the candidates on.
+ */
+void setupComputerPlayer( ComputerPlayer *cp, ComputerPlayerDifficulty difficulty );
+
+/**
+ * @brief Stops the search in progress and the simulation threads.
+ */
+void destroyComputerPlayer( ComputerPlayer *cp );
+
+/**
+ * @brief Changes the difficulty, which is the time budget of each search.
+ * Takes effect in the next search.
+ */
+void setComputerPlayerDifficulty( ComputerPlayer *cp, ComputerPlayerDifficulty difficulty );
+
+/**
+ * @brief Name of the difficulty, for the HUD.
+ */
+const char *getComputerPlayerDifficultyName( ComputerPlayerDifficulty difficulty );
+
+/**
+ * @brief Starts searching a shot for the current cue stick of gw. The world
+ * is copied, so gw may change while the search runs.
+ */
+void startComputerPlayerSearch( ComputerPlayer *cp, const GameWorld *gw );
+
+/**
+ * @brief Returns true and fills shot when the search is over. Never blocks:
+ * if the search could not get its own thread, each call searches for a
+ * small slice of time on the calling thread instead.
+ */
+bool pollComputerPlayerSearch( ComputerPlayer *cp, ShotParams *shot );
+
+/**
+ * @brief Stops the search in progress, if any, and discards its result.
+ */
+void cancelComputerPlayerSearch( ComputerPlayer *cp );
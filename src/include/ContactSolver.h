@@ -0,0 +1,36 @@
+/**
+ * @file ContactSolver.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Simultaneous ball x ball contact solver function declarations.
+ * Every contact of a group of touching balls is solved together with
+ * iterated impulses, so the outcome does not depend on the ball order.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+/**
+ * @brief Forgets every impulse, so the next solve starts from scratch.
+ */
+void setupContactSolver( ContactSolver *cs );
+
+/**
+ * @brief Keeps the impulses of the step that ended as the first guess of
+ * the contacts that are still there in the next one. Only the pairs solved
+ * are visited, so it costs nothing on a table at rest.
+ */
+void beginContactSolverStep( ContactSolver *cs );
+
+/**
+ * @brief Solves the contacts of the balls touching the pair a x b, directly
+ * or through other balls, like a rack. The contacts get their impulses in
+ * waves: the ones approaching are solved together, then the ones they
+ * started to push, until every contact separates. Overlaps are undone at
+ * the end. Only the candidate balls are searched for the group. Works on
+ * the velocities and positions of the physics state bb. The contacts are
+ * written to contacts, in pair order, and their count is returned.
+ */
+int solveBallContacts( ContactSolver *cs, BallBatch *bb, const int *candidates, int candidateCount, int a, int b, BallContact *contacts );
@@ -10,4 +10,5 @@
 
 #include "Types.h"
 
+void setupCushion( Cushion *c );
 void drawCushion( Cushion *c );
@@ -0,0 +1,66 @@
+/**
+ * @file Determinism.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Deterministic simulation support function declarations: a seeded
+ * random number generator owned by each GameWorld, math functions built
+ * only from IEEE 754 basic operations (so they give the same bits on every
+ * platform, native and WebAssembly) and the world state checksum.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Types.h"
+
+#define CHECKSUM_START 2166136261u
+
+/**
+ * @brief Seeds the generator. Any seed is valid, including zero.
+ */
+void seedRandom( RandomGenerator *rng, uint64_t seed );
+
+/**
+ * @brief Returns a random value between min and max (both included).
+ */
+int nextRandomValue( RandomGenerator *rng, int min, int max );
+
+/**
+ * @brief e raised to x.
+ */
+double portableExp( double x );
+
+/**
+ * @brief Natural logarithm of x, for x > 0.
+ */
+double portableLog( double x );
+
+/**
+ * @brief base raised to exponent, for base > 0.
+ */
+double portablePow( double base, double exponent );
+
+/**
+ * @brief Sine of x radians.
+ */
+double portableSin( double x );
+
+/**
+ * @brief Cosine of x radians.
+ */
+double portableCos( double x );
+
+/**
+ * @brief FNV-1a hash of everything that the physics and the rules depend
+ * on: balls, turn state and statistics. Pointers are hashed as indexes.
+ */
+uint32_t checksumGameWorld( GameWorld *gw );
+
+/**
+ * @brief Adds size bytes of data to an FNV-1a hash. The first call takes
+ * CHECKSUM_START.
+ */
+uint32_t checksumBytes( uint32_t hash, const void *data, size_t size );
@@ -12,4 +12,5 @@
 
 void setupEBP( GameWorld *gw );
 void applyRulesEBP( GameWorld *gw );
-void resetCueBallPosition( GameWorld *gw );
\ No newline at end of file
+void onEventEBP( GameWorld *gw, const SimulationEvent *event );
+BallMask legalTargetsEBP( const GameWorld *gw );
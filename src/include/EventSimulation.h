@@ -0,0 +1,33 @@
+/**
+ * @file EventSimulation.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Event driven (time of impact) shot simulation function
+ * declarations. Instead of stepping, the next ball x ball contact, cushion
+ * hit, pocket capture or ball stop is predicted analytically and the
+ * simulation jumps straight to it. The responses are the ones of the
+ * stepper: the contact solver, the cushion and pocket code and BallMotion,
+ * so the balls end close to where the stepper leaves them.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+#define EVENT_SIMULATION_MAX_EVENTS 20000
+
+/**
+ * @brief Resolves the motion of the balls of the physics state until
+ * every ball stops. The shots it can't finish, because the events never
+ * end or there is no memory for them, are finished by stepping. Returns
+ * the number of events processed.
+ */
+int resolveShotEvents( GameWorld *gw );
+
+/**
+ * @brief Event driven counterpart of simulateShot: strikes the cue ball,
+ * resolves the shot and applies the rules. Returns the number of events
+ * processed.
+ */
+int simulateShotEvents( GameWorld *gw, float angle, int power, Vector2 hitPoint );
@@ -0,0 +1,61 @@
+/**
+ * @file GameRules.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Game rules function declarations. Each game played on the table
+ * is a GameRules table of functions: it racks the balls, reads the events
+ * of the physics, judges the shot when the balls stop and tells which balls
+ * may be hit first. The world only keeps which game it is, so a world is
+ * still cloned, saved and replayed as plain data.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+#define GAME_RULES_COUNT 3
+
+// a 9 foot pool table and a 12 foot snooker table drawn at the same size:
+// the snooker balls and pockets are half as big
+#define POOL_TABLE_LAYOUT { 700, 350, BALL_RADIUS, 1.0f, 0.25f, 16 }
+#define SNOOKER_TABLE_LAYOUT { 700, 350, 5, 0.5f, 0.16f, 22 }
+
+/**
+ * @brief The rules of a game.
+ */
+const GameRules *getGameRules( GameRulesType type );
+
+/**
+ * @brief Starts a match of a game, racking the balls from the generator
+ * of the world.
+ */
+void setupGame( GameWorld *gw, GameRulesType type );
+
+/**
+ * @brief Sets up everything every game shares on the table of the layout
+ * of a game: the cushions, the pockets, the cue ball, the cue sticks, the
+ * clock and the physics state. The object balls are numbered in order and
+ * left on the table for the rules to rack.
+ */
+void setupTable( GameWorld *gw, GameRulesType type );
+
+/**
+ * @brief Color of the ball with a number, shared by solids and stripes.
+ */
+Color ballColor( int number );
+
+/**
+ * @brief Where the apex of the rack goes.
+ */
+Vector2 footSpot( const GameWorld *gw );
+
+/**
+ * @brief Puts the cue ball back on its starting position.
+ */
+void resetCueBallPosition( GameWorld *gw );
+
+/**
+ * @brief Empties the statistics of the turn.
+ */
+void resetTurnStatistics( GameWorld *gw );
@@ -0,0 +1,18 @@
+/**
+ * @file NineBallRules.h
+ * @author Prof. Dr. David Buzatto
+ * @brief 9 Ball Pool rules functions declarations. Only the balls 1 to 9
+ * are racked, the lowest one on the table must be hit first and whoever
+ * pockets the 9 legally wins.
+ * 
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+void setupNineBall( GameWorld *gw );
+void applyRulesNineBall( GameWorld *gw );
+void onEventNineBall( GameWorld *gw, const SimulationEvent *event );
+BallMask legalTargetsNineBall( const GameWorld *gw );
@@ -0,0 +1,62 @@
+/**
+ * @file PositionTrace.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Position trace function declarations. The trace keeps the ball
+ * positions of every physics step of the last shot, quantized to 16 bits,
+ * in a ring allocated once and strided by the ball count of the game, so
+ * the shot can be watched again in slow motion without simulating it
+ * again.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "Types.h"
+
+#define POSITION_TRACE_SIZE 262144     // 512 KB, 68 seconds of steps with 16 balls
+#define POSITION_TRACE_SCALE 8.0f
+#define POSITION_TRACE_OFF_TABLE INT16_MIN
+
+/**
+ * @brief Allocates room for size coordinates, in frames stepDelta seconds
+ * apart. How many frames fit depends on the balls of the first frame.
+ */
+void setupPositionTrace( PositionTrace *pt, int size, float stepDelta );
+
+/**
+ * @brief Frees the frames of the trace.
+ */
+void destroyPositionTrace( PositionTrace *pt );
+
+/**
+ * @brief Forgets every frame, keeping the memory.
+ */
+void clearPositionTrace( PositionTrace *pt );
+
+/**
+ * @brief Appends the current ball positions of gw. When the ring is full the
+ * oldest frame is overwritten, and a world with another ball count than the
+ * frames kept forgets them first. Does nothing if pt is NULL.
+ */
+void recordPositionTrace( PositionTrace *pt, const GameWorld *gw );
+
+/**
+ * @brief Ball positions at the fractional frame, interpolated between the
+ * two nearest frames and clamped to the frames kept. visible tells which
+ * balls are on the table. Returns false if the trace is empty.
+ */
+bool samplePositionTrace( const PositionTrace *pt, float frame, Vector2 *positions, bool *visible );
+
+/**
+ * @brief Starts watching the trace from its first frame.
+ */
+void setupPositionTraceView( PositionTraceView *view, float speed );
+
+/**
+ * @brief Moves the view delta seconds of real time forward, at its speed.
+ * Returns false when the end of the trace was reached.
+ */
+bool updatePositionTraceView( PositionTraceView *view, const PositionTrace *pt, float delta );
@@ -0,0 +1,96 @@
+/**
+ * @file Replay.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Match replay function declarations. A replay only stores the
+ * inputs of a match: the rack seed, the shots and the balls moved by hand.
+ * As the physics is deterministic, simulating the inputs again gives the
+ * same match. Every keyframeInterval shots a snapshot of the table is kept,
+ * so seeking a shot only simulates the few shots after the nearest keyframe.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Types.h"
+
+#define REPLAY_VERSION 7
+#define REPLAY_KEYFRAME_INTERVAL 8
+#define REPLAY_MAX_SPEED 100
+
+/**
+ * @brief Starts an empty replay of a match of a game racked from a
+ * generator in the rackSeed state and played on the quality preset.
+ */
+void setupReplay( Replay *replay, GameRulesType rulesType, uint64_t rackSeed, SimulationQuality quality, int keyframeInterval );
+
+/**
+ * @brief Frees the records and keyframes of the replay.
+ */
+void destroyReplay( Replay *replay );
+
+/**
+ * @brief Records the shot of the current cue stick of gw, which is about to
+ * be played. Keeps a keyframe of gw when one is due.
+ */
+void recordReplayShot( Replay *replay, const GameWorld *gw );
+
+/**
+ * @brief Records the checksum of the world after the last recorded shot.
+ */
+void recordReplayShotResult( Replay *replay, uint32_t checksum );
+
+/**
+ * @brief Records a ball moved by hand to position.
+ */
+void recordReplayPlacement( Replay *replay, int ball, Vector2 position );
+
+/**
+ * @brief Cuts the replay after its first recordCount records, for shots
+ * that were undone. It may also grow back up to records cut before, as long
+ * as nothing was recorded since.
+ */
+void setReplayLength( Replay *replay, int recordCount );
+
+/**
+ * @brief Writes the replay to a binary file. Returns false on errors.
+ */
+bool saveReplay( const Replay *replay, const char *path );
+
+/**
+ * @brief Reads a replay written by saveReplay into an unused replay.
+ * Returns false (leaving the replay empty) on errors.
+ */
+bool loadReplay( Replay *replay, const char *path );
+
+/**
+ * @brief Puts gw in the state right before the given shot: racks the balls,
+ * restores the nearest keyframe and simulates the shots after it headless.
+ * Returns the index of the first record after that state.
+ */
+int seekReplay( const Replay *replay, GameWorld *gw, int shot );
+
+/**
+ * @brief Simulates the whole replay headless and returns the first shot
+ * whose checksum differs from the recorded one, or -1 if none does.
+ */
+int verifyReplay( const Replay *replay, GameWorld *gw );
+
+/**
+ * @brief Prepares a player for the replay, at the start of the match.
+ */
+void setupReplayPlayer( ReplayPlayer *rp, Replay *replay, GameWorld *gw );
+
+/**
+ * @brief Jumps to the state right before the given shot.
+ */
+void seekReplayPlayer( ReplayPlayer *rp, GameWorld *gw, int shot );
+
+/**
+ * @brief Plays delta seconds of the replay, times the player speed.
+ * Returns the reports of every physics step taken, summed.
+ */
+SimulationStepReport updateReplayPlayer( ReplayPlayer *rp, GameWorld *gw, float delta );
@@ -0,0 +1,31 @@
+/**
+ * @file SaveGame.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Saved match function declarations. The whole state of a game
+ * world, balls in motion included, goes to a versioned little endian binary
+ * file, with the pointers stored as indexes and the world checksum at the
+ * end, so a match can be suspended and resumed exactly where it was.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "Types.h"
+
+#define SAVE_GAME_VERSION 6
+
+/**
+ * @brief Writes gw to path, through a temporary file that replaces the old
+ * one only when complete. Returns false on errors.
+ */
+bool saveGameWorld( const GameWorld *gw, const char *path );
+
+/**
+ * @brief Reads a world written by saveGameWorld into gw, without racking
+ * anything. gw is left untouched and false is returned if the file is
+ * missing, of another version, truncated or fails the checksum.
+ */
+bool loadGameWorld( GameWorld *gw, const char *path );
@@ -0,0 +1,46 @@
+/**
+ * @file ShotPreview.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Shot preview function declarations. A worker thread plays the
+ * aimed shot with the real physics on a copy of the world and hands back
+ * where every ball comes to rest. Requests and results go through atomic
+ * mailboxes, so the game loop never waits for the worker, and a new request
+ * makes the worker drop the one it is simulating. Between requests the
+ * worker sleeps on a condition variable.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "Types.h"
+
+/**
+ * @brief Configures a disabled preview and starts its worker thread. Without
+ * threads the shot is simulated a slice at a time by updateShotPreview.
+ */
+void setupShotPreview( ShotPreview *sp );
+
+/**
+ * @brief Stops the worker thread and frees everything.
+ */
+void destroyShotPreview( ShotPreview *sp );
+
+/**
+ * @brief Asks for the outcome of the shot of the current cue stick of gw,
+ * dropping the previous request.
+ */
+void requestShotPreview( ShotPreview *sp, const GameWorld *gw );
+
+/**
+ * @brief Drops the request in progress and the result shown.
+ */
+void cancelShotPreview( ShotPreview *sp );
+
+/**
+ * @brief Takes the result of the last request if the worker published it,
+ * without waiting. Returns whether sp->result holds it.
+ */
+bool updateShotPreview( ShotPreview *sp );
@@ -0,0 +1,136 @@
+/**
+ * @file Simulation.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless shot simulation function declarations. Nothing here
+ * depends on the window, the input devices or the audio device, so it can
+ * be built into the libebpsim static library.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "Types.h"
+
+#define SIMULATION_MAX_SHOT_STEPS 36000
+
+/**
+ * @brief Configures a fixed step clock with a quality preset, which runs
+ * the preset substeps for each 1/frameRate seconds of real time.
+ */
+void setupSimulationClock( SimulationClock *clock, int frameRate, SimulationQuality quality, int maxStepsPerFrame );
+
+/**
+ * @brief Step adaptation settings of a quality preset.
+ */
+SimulationPreset getSimulationPreset( SimulationQuality quality );
+
+/**
+ * @brief How many fixed steps the next step of the clock covers: more than
+ * one only while every ball is slow enough for the preset. Depends only on
+ * the balls, so the game, the replays and the searches agree on it.
+ */
+int planClockStep( const GameWorld *gw );
+
+/**
+ * @brief Advances the physics by fixedSteps fixed steps at once, split in
+ * as many substeps as the fastest ball needs for the preset.
+ */
+SimulationStepReport simulateClockStep( GameWorld *gw, int fixedSteps );
+
+/**
+ * @brief Plans and runs the next step of the clock. Every headless loop
+ * that plays a shot to the end goes through here.
+ */
+SimulationStepReport simulateNextStep( GameWorld *gw );
+
+/**
+ * @brief Advances the physics of all the balls by delta seconds, resolving
+ * cushion, ball and pocket collisions. What happened is pushed to the event
+ * ring of the world and applied to the turn statistics at the end of the
+ * step. Balls at rest sleep and cost nothing until a ball x ball contact
+ * wakes them up.
+ */
+SimulationStepReport simulateStep( GameWorld *gw, float delta );
+
+/**
+ * @brief Accumulates frameDelta seconds of real time and runs as many clock
+ * steps as fit in it, up to the clock limit of fixed steps. A merged step
+ * waits for all of its time. Time beyond the limit is dropped. The ball
+ * positions after each fixed step are appended to trace, if it is not NULL.
+ * Returns the reports of every step taken, summed.
+ */
+SimulationStepReport advanceSimulation( GameWorld *gw, float frameDelta, PositionTrace *trace );
+
+/**
+ * @brief Runs the clock steps of the shot in progress without waiting for
+ * real time, until every ball stops or about maxSteps fixed steps ran. The
+ * steps are the ones advanceSimulation would take, so the shot ends exactly
+ * the same, and are appended to trace, if it is not NULL. The real time
+ * waiting in the clock is dropped. Returns the reports of every step taken,
+ * summed.
+ */
+SimulationStepReport fastForwardSimulation( GameWorld *gw, int maxSteps, PositionTrace *trace );
+
+/**
+ * @brief Ends the shot early when no moving ball can reach a cushion, a
+ * pocket or another ball before it stops: what is left is only friction,
+ * so every ball goes straight to its analytic rest point and true is
+ * returned. Otherwise nothing changes. The rest points are a little short
+ * of where stepping would leave the balls, so this is for searches, not
+ * for the game itself.
+ */
+bool settleQuietBalls( GameWorld *gw );
+
+/**
+ * @brief Adds the counts of step to total. ballsMoving is the one of step.
+ */
+void mergeStepReport( SimulationStepReport *total, SimulationStepReport *step );
+
+/**
+ * @brief Applies the events pushed since the last call to the turn
+ * statistics and hands them to the rules of the game, in the order they
+ * happened. Every step ends with it.
+ */
+void applySimulationEvents( GameWorld *gw );
+
+/**
+ * @brief Ball x cushion response for the ball i of the physics state,
+ * already placed at the contact point: reflection, cue ball spin,
+ * elasticity and the hit event.
+ */
+void collideBallWithCushion( GameWorld *gw, int i, Vector2 normal );
+
+/**
+ * @brief Removes the ball i of the physics state from the table and pushes
+ * its event for the rules. The cue ball goes back to its starting position.
+ */
+void pocketBall( GameWorld *gw, int i );
+
+/**
+ * @brief Transfers the current cue stick angle, power and hit point to
+ * the cue ball and marks the shot to be judged when the balls stop.
+ */
+void strikeCueBall( GameWorld *gw );
+
+/**
+ * @brief Passes the turn, applies the rules of the game after the balls
+ * stopped and empties the turn statistics. Does nothing and returns false
+ * if there is no shot pending.
+ */
+bool finishShot( GameWorld *gw );
+
+/**
+ * @brief Copies the world src into dst, rebasing the cue ball and cue stick
+ * pointers to the copies inside dst.
+ */
+void cloneGameWorld( GameWorld *dst, const GameWorld *src );
+
+/**
+ * @brief Plays a complete shot from the current state, stepping the
+ * physics with the clock until every ball stops and then applying the
+ * rules. Returns the number of steps taken.
+ */
+int simulateShot( GameWorld *gw, float angle, int power, Vector2 hitPoint );
@@ -0,0 +1,43 @@
+/**
+ * @file SimulationEvents.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Simulation event ring function declarations. The physics only
+ * pushes what happened (hits, pocketed balls, stops) to the ring of the
+ * world; the rules, the audio and anyone else read it after the step.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Types.h"
+
+/**
+ * @brief Empties the ring.
+ */
+void setupSimulationEvents( SimulationEventBuffer *events );
+
+/**
+ * @brief Appends an event. A ball hit of a pair already hit since the last
+ * endSimulationEventStep is added to that event instead, so a contact
+ * solved again later in the step is heard and counted once. An event that
+ * doesn't fit in the ring before the step is applied is dropped and counted
+ * in events->dropped.
+ */
+void pushSimulationEvent( SimulationEventBuffer *events, SimulationEvent event );
+
+/**
+ * @brief Marks the events pushed so far as applied to the rules.
+ */
+void endSimulationEventStep( SimulationEventBuffer *events );
+
+/**
+ * @brief Reads the event at *cursor and moves it forward. A cursor left
+ * behind by more than the capacity skips to the oldest event kept, and
+ * one ahead of the ring (the world was replaced) is moved back to its end.
+ * Returns false when there is nothing new.
+ */
+bool readSimulationEvent( const SimulationEventBuffer *events, uint32_t *cursor, SimulationEvent *event );
@@ -0,0 +1,36 @@
+/**
+ * @file Snapshot.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Game snapshot function declarations. A snapshot holds what changes
+ * between two shots (ball positions and the rule state) in a plain struct
+ * without pointers, so it can be copied, stored and written to files as is.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+/**
+ * @brief Copies the table and rule state of gw into snapshot. The balls
+ * should be stopped: velocities and spins are not kept.
+ */
+void captureGameSnapshot( GameSnapshot *snapshot, const GameWorld *gw );
+
+/**
+ * @brief Puts gw back in the state of snapshot, rack included. gw must be
+ * set up for the game the snapshot was taken from.
+ */
+void restoreGameSnapshot( GameWorld *gw, const GameSnapshot *snapshot );
+
+/**
+ * @brief 0 for the cue stick of P1, 1 for the one of P2 and -1 for NULL, to
+ * store the cue stick pointers of gw.
+ */
+int cueStickToIndex( const GameWorld *gw, const CueStick *cs );
+
+/**
+ * @brief The cue stick of gw stored as index by cueStickToIndex.
+ */
+CueStick *indexToCueStick( GameWorld *gw, int index );
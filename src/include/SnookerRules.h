@@ -0,0 +1,32 @@
+/**
+ * @file SnookerRules.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Snooker rules functions declarations. 15 reds and 6 colours are
+ * played on a table twice as big as the balls: a red and then a colour are
+ * potted in turns while reds are left, then the colours in order. Every
+ * ball potted is worth points, fouls give points to the opponent and the
+ * highest score wins. There is no free ball nor miss.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+void setupSnooker( GameWorld *gw );
+void applyRulesSnooker( GameWorld *gw );
+void onEventSnooker( GameWorld *gw, const SimulationEvent *event );
+BallMask legalTargetsSnooker( const GameWorld *gw );
+
+/**
+ * @brief Points of a ball: 1 for the reds, 2 (yellow) to 7 (black) for the
+ * colours.
+ */
+int snookerBallValue( int number );
+
+/**
+ * @brief Where the baulk line crosses the table and the radius of the D.
+ */
+float snookerBaulkLine( const GameWorld *gw );
+float snookerDRadius( const GameWorld *gw );
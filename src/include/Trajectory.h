@@ -0,0 +1,32 @@
+/**
+ * @file Trajectory.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Aiming trajectory function declarations. The cue ball is followed
+ * through its cushion bounces up to the first ball it hits, and that ball
+ * through its own bounces, using the cushion polygons and the same decay
+ * law as the physics to know where they stop.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include "Types.h"
+
+#define TRAJECTORY_MAX_BOUNCES 4
+
+/**
+ * @brief Predicts the shot of the current cue stick of gw.
+ */
+TrajectoryPrediction predictTrajectory( const GameWorld *gw );
+
+/**
+ * @brief The prediction for the current cue stick of gw, computed again only
+ * when its angle, power or hit point or any ball changed since the last call.
+ */
+const TrajectoryPrediction *getCachedTrajectory( TrajectoryCache *cache, const GameWorld *gw );
+
+/**
+ * @brief Forces the next getCachedTrajectory to compute the prediction.
+ */
+void invalidateTrajectoryCache( TrajectoryCache *cache );
@@ -8,8 +8,15 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include "raylib/raylib.h"
 
+#include "CommonMacros.h"
+
+// set of balls, the bit n is the ball numbered n (the cue ball is 0)
+typedef uint32_t BallMask;
+
 typedef enum GameState {
     GAME_STATE_BREAKING,
     GAME_STATE_OPEN_TABLE,
@@ -40,6 +47,25 @@ typedef enum BallGroup {
     BALL_GROUP_STRIPED
 } BallGroup;
 
+typedef enum SimulationQuality {
+    SIMULATION_QUALITY_LOW,
+    SIMULATION_QUALITY_MEDIUM,
+    SIMULATION_QUALITY_HIGH
+} SimulationQuality;
+
+typedef enum GameRulesType {
+    GAME_RULES_EIGHT_BALL,
+    GAME_RULES_NINE_BALL,
+    GAME_RULES_SNOOKER
+} GameRulesType;
+
+typedef enum SimulationEventType {
+    SIMULATION_EVENT_BALL_HIT,          // value: impulse, as the speed each ball gained
+    SIMULATION_EVENT_CUSHION_HIT,       // value: speed into the cushion
+    SIMULATION_EVENT_BALL_POCKETED,     // value: speed of the ball falling
+    SIMULATION_EVENT_BALL_STOPPED
+} SimulationEventType;
+
 typedef struct Ball {
     Vector2 center;
     Vector2 prevPos;
@@ -48,9 +74,10 @@ typedef struct Ball {
     Vector2 vel;
     float friction;
     float elasticity;
-    bool moving;
+    bool moving;       // a ball that is not moving sleeps until a contact wakes it
     Color color;
     bool striped;
+    bool plain;        // drawn in its color, without the numbered texture
     int number;
     bool pocketed;
 } Ball;
@@ -66,8 +93,8 @@ typedef struct CueStick {
     int maxPower;
     Vector2 hitPoint;    // point of impact, -1 to 1 (0,0 = center)
     Color color;
-    int pocketedBalls[7];
-    int pocketedCount;
+    BallMask pocketed;   // balls pocketed by the player
+    int score;           // points, for the games that count them
     CueStickType type;
     CueStickState state;
     BallGroup group;
@@ -75,6 +102,11 @@ typedef struct CueStick {
 
 typedef struct Cushion {
     Vector2 vertices[4];
+    // baked by setupCushion
+    Vector2 edgeDirections[4];  // unit vector from vertex i to vertex i+1
+    Vector2 edgeNormals[4];     // unit normal of each edge, pointing outward
+    float edgeLengths[4];
+    Rectangle bounds;
 } Cushion;
 
 typedef struct Pocket {
@@ -82,31 +114,133 @@ typedef struct Pocket {
     int radius;
 } Pocket;
 
+typedef struct TableLayout {
+    // playing surface and ball size in pixels; the pockets and the jaws of
+    // the cushions of the pool table are scaled by pocketScale
+    float width;
+    float height;
+    int ballRadius;
+    float pocketScale;
+    float cueBallSpot;      // from the head cushion, in table widths
+    int ballCount;          // the cue ball included
+} TableLayout;
+
 typedef struct TurnStatistics {
     // statistics for game flow control
     int cueBallHits;
     int cueBallFirstHitNumber;
     bool cueBallPocketed;
-    bool ballsTouchedCushion[16];
-    int pocketedBalls[16];
-    int pocketedCount;
+    BallMask touchedCushion;
+    BallMask pocketed;          // object balls
 } TurnStatistics;
 
+typedef struct SimulationPreset {
+    // distances are in ball radii, travelled by the fastest ball in one step
+    int substeps;             // fixed steps for each frame
+    float maxDisplacement;    // a step is split while going further
+    int maxSplits;            // substeps a step may be split into
+    float mergeDisplacement;  // fixed steps are merged while going less far
+    int maxMerges;            // fixed steps one step may cover
+} SimulationPreset;
+
+typedef struct SimulationClock {
+    float fixedDelta;       // duration of one physics step
+    float accumulator;      // real time not simulated yet
+    int maxStepsPerFrame;   // avoids the spiral of death on slow frames
+    SimulationQuality quality;
+    SimulationPreset preset;
+} SimulationClock;
+
+typedef struct BallBatch {
+    // physics state of the balls as a structure of arrays, lane i is ball i
+    // of the world; 16 byte aligned, what malloc gives, so a world on the
+    // heap keeps the SSE loads aligned
+    float x[BALL_CAPACITY] __attribute__(( aligned( 16 ) ));
+    float y[BALL_CAPACITY] __attribute__(( aligned( 16 ) ));
+    float px[BALL_CAPACITY] __attribute__(( aligned( 16 ) ));    // position at the start of the step
+    float py[BALL_CAPACITY] __attribute__(( aligned( 16 ) ));
+    float vx[BALL_CAPACITY] __attribute__(( aligned( 16 ) ));
+    float vy[BALL_CAPACITY] __attribute__(( aligned( 16 ) ));
+    float sx[BALL_CAPACITY] __attribute__(( aligned( 16 ) ));
+    float sy[BALL_CAPACITY] __attribute__(( aligned( 16 ) ));
+    float radius[BALL_CAPACITY] __attribute__(( aligned( 16 ) ));
+    int moving[BALL_CAPACITY] __attribute__(( aligned( 16 ) ));  // all ones for a moving ball
+    bool pocketed[BALL_CAPACITY];
+} BallBatch;
+
+typedef struct BallPair {
+    int a;
+    int b;
+} BallPair;
+
+// pairs a < b of BALL_CAPACITY balls
+#define CONTACT_SOLVER_MAX_CONTACTS ( BALL_CAPACITY * ( BALL_CAPACITY - 1 ) / 2 )
+
+typedef struct Broadphase {
+    int order[BALL_CAPACITY];                       // ball indexes sorted by the left side of their bounds
+    BallPair pairs[CONTACT_SOLVER_MAX_CONTACTS];    // candidate pairs of the last update, a < b
+    int pairCount;
+    int islands[BALL_CAPACITY];                     // island of each ball, -1 for balls out of every pair
+    int islandCount;
+} Broadphase;
+
+typedef struct BallContact {
+    int a;                  // ball indexes, a < b
+    int b;
+    Vector2 normal;         // from a to b
+    float target;           // normal speed the contact must separate with
+    float impulse;          // accumulated normal impulse, never negative
+} BallContact;
+
+typedef struct ContactSolver {
+    float impulses[CONTACT_SOLVER_MAX_CONTACTS];        // impulse of each ball pair solved in this step
+    float warmImpulses[CONTACT_SOLVER_MAX_CONTACTS];    // the ones of the last step, first guess of the solver
+    int solvedPairs[CONTACT_SOLVER_MAX_CONTACTS];       // pairs given an impulse in this step
+    int solvedCount;
+    int warmPairs[CONTACT_SOLVER_MAX_CONTACTS];         // and in the last one
+    int warmCount;
+    int iterations;                                     // iterations run by the last solve
+} ContactSolver;
+
+typedef struct RandomGenerator {
+    uint64_t state;         // xorshift64* state, never zero
+} RandomGenerator;
+
+typedef struct SimulationEvent {
+    uint8_t type;       // SimulationEventType
+    uint8_t a;          // ball index, the cue ball comes first in a hit
+    uint8_t b;          // other ball of a hit
+    float value;
+} SimulationEvent;
+
+#define SIMULATION_EVENT_CAPACITY 1024
+
+typedef struct SimulationEventBuffer {
+    // ring of what the physics did; the sequence numbers only grow, each
+    // reader keeps its own
+    SimulationEvent events[SIMULATION_EVENT_CAPACITY];
+    uint32_t written;       // events ever pushed
+    uint32_t stepStart;     // first event not applied to the rules yet
+    uint32_t dropped;       // events lost to a full step, should stay 0
+} SimulationEventBuffer;
+
 typedef struct GameWorld {
 
     Rectangle boundarie;
     Cushion cushions[6];
     Pocket pockets[6];
     Ball *cueBall;
-    Ball balls[16];
+    Ball balls[BALL_CAPACITY];
+    int ballCount;          // balls in play or pocketed, the cue ball included
     CueStick cueStickP1;
     CueStick cueStickP2;
     CueStick *currentCueStick;
+    GameRulesType rulesType;
     GameState state;
     GameBallsState ballsState;
 
     // for HUD and game logic
-    int pocketedBalls[15];
+    int pocketedBalls[BALL_CAPACITY];
     int pocketedCount;
 
     CueStick *lastCueStick;
@@ -117,11 +251,41 @@ typedef struct GameWorld {
 
     // game logic
     bool applyRules;
+    BallMask ballsOn;       // next balls to hit, for the rules that keep them
+
+    SimulationClock clock;
+    BallBatch physics;      // what the steps work on, balls is its view for drawing and the rules
+    Broadphase broadphase;
+    ContactSolver contactSolver;
+    SimulationEventBuffer events;
+
+    // determinism: the same seed and shots give the same checksums
+    RandomGenerator rng;
+    uint32_t checksum;      // world state after the last shot
 
     TurnStatistics statistics;
 
 } GameWorld;
 
+typedef struct GameRules {
+    // one game played on the table, everything else is shared
+    const char *name;
+    TableLayout layout;
+    void (*setup)( GameWorld *gw );
+    void (*onEvent)( GameWorld *gw, const SimulationEvent *event );
+    void (*onShotEnd)( GameWorld *gw );
+    BallMask (*legalTargets)( const GameWorld *gw );
+    bool (*isGameOver)( const GameWorld *gw );
+} GameRules;
+
+typedef struct BallMotionState {
+    // where a ball rolling free is after some time
+    Vector2 center;
+    Vector2 vel;
+    Vector2 spin;
+    bool moving;
+} BallMotionState;
+
 typedef struct CollisionResult {
     bool hasCollision;
     float t;              // collision time (0 to 1)
@@ -129,11 +293,186 @@ typedef struct CollisionResult {
     Vector2 normal;       // collision normal
 } CollisionResult;
 
+typedef struct SimulationStepReport {
+    // what happened is in the event ring of the world
+    int events;             // pushed during the steps
+    bool ballsMoving;
+} SimulationStepReport;
+
+typedef struct ShotParams {
+    float angle;
+    int power;
+    Vector2 hitPoint;
+} ShotParams;
+
+typedef struct ShotOutcome {
+    // the table after a shot simulated by simulateShotsBatch
+    bool simulated;             // false when there was no memory to play the shot
+    Vector2 positions[BALL_CAPACITY];
+    bool pocketed[BALL_CAPACITY];
+    TurnStatistics statistics;  // of the shot, before the rules reset them
+    GameState state;            // after the rules
+    bool keepsTurn;             // the shooter plays again
+    bool gameOver;              // the rules ended the game
+    bool wins;                  // the shooter won the game
+    int points;                 // scored by the shooter less scored by the opponent
+    int steps;
+    uint32_t checksum;
+} ShotOutcome;
+
+typedef struct BatchSimulator {
+    struct BatchWorkerPool *pool;   // threads kept from setup to destroy, NULL if none started
+    GameWorld *world;               // the one of the calling thread
+    int threadCount;                // the workers and the calling thread
+} BatchSimulator;
+
+typedef enum ComputerPlayerDifficulty {
+    COMPUTER_PLAYER_DIFFICULTY_EASY,
+    COMPUTER_PLAYER_DIFFICULTY_MEDIUM,
+    COMPUTER_PLAYER_DIFFICULTY_HARD
+} ComputerPlayerDifficulty;
+
+typedef struct ComputerPlayer {
+    bool enabled;
+    ComputerPlayerDifficulty difficulty;
+    float timeBudget;                       // seconds of search for each shot
+    struct ComputerPlayerSearch *search;    // search in progress, NULL if idle
+    BatchSimulator simulator;               // plays the candidates of every search
+} ComputerPlayer;
+
+typedef struct ShotPreviewResult {
+    int generation;                     // request this is the outcome of
+    Vector2 positions[BALL_CAPACITY];   // where every ball comes to rest
+    bool pocketed[BALL_CAPACITY];
+} ShotPreviewResult;
+
+typedef struct ShotPreview {
+    bool enabled;
+    struct ShotPreviewWorker *worker;   // thread, mailboxes and job in progress
+    int generation;                     // last request made
+    ShotPreviewResult result;           // last outcome taken from the worker
+    bool hasResult;                     // result is the one of the last request
+} ShotPreview;
+
+typedef struct GameSnapshot {
+    // the table at rest and the rule state, velocities are not kept
+    int ballCount;
+    Vector2 centers[BALL_CAPACITY];
+    bool pocketed[BALL_CAPACITY];
+    int numbers[BALL_CAPACITY];         // the rack, an invalid break racks again
+    bool striped[BALL_CAPACITY];
+    Color colors[BALL_CAPACITY];
+    BallGroup groups[2];
+    BallMask cueStickPocketed[2];
+    int scores[2];
+    BallMask ballsOn;
+    int currentCueStick;                // 0 for P1, 1 for P2, -1 for none
+    int lastCueStick;
+    int winnerCueStick;
+    GameState state;
+    int pocketedBalls[BALL_CAPACITY];
+    int pocketedCount;
+    TurnStatistics statistics;
+    uint64_t rngState;
+} GameSnapshot;
+
+typedef enum ReplayRecordType {
+    REPLAY_RECORD_SHOT,
+    REPLAY_RECORD_PLACEMENT
+} ReplayRecordType;
+
+typedef struct ReplayRecord {
+    ReplayRecordType type;
+    ShotParams shot;            // shot records
+    uint32_t checksum;          // shot records, world after the shot
+    int ball;                   // placement records
+    Vector2 position;           // placement records
+} ReplayRecord;
+
+typedef struct ReplayKeyframe {
+    int shot;                   // the keyframe is the table before this shot
+    int record;                 // index of that shot record
+    GameSnapshot snapshot;
+} ReplayKeyframe;
+
+typedef struct Replay {
+    GameRulesType rulesType;    // the game played
+    uint64_t rackSeed;          // generator state the game racked from
+    SimulationQuality quality;  // physics preset the match was played on
+    int keyframeInterval;       // shots between keyframes
+    int shotCount;
+    ReplayRecord *records;
+    int recordCount;
+    int recordCapacity;
+    ReplayKeyframe *keyframes;
+    int keyframeCount;
+    int keyframeCapacity;
+} Replay;
+
+typedef struct ReplayPlayer {
+    Replay *replay;
+    int nextRecord;
+    int nextShot;               // shots played so far
+    int speed;                  // 1 to 100 times the real time
+    bool paused;
+    float wait;                 // pause between shots
+} ReplayPlayer;
+
+typedef struct UndoEntry {
+    GameSnapshot snapshot;
+    int replayLength;           // records of the match replay at that moment
+} UndoEntry;
+
+typedef struct UndoHistory {
+    UndoEntry *entries;         // ring allocated once, the oldest is dropped
+    int capacity;
+    int first;                  // oldest entry kept
+    int count;
+    int cursor;                 // entries before the present, the rest is redo
+} UndoHistory;
+
+typedef struct PositionTrace {
+    // ball centers in 1/8 pixel units, POSITION_TRACE_OFF_TABLE if pocketed,
+    // x and y of each ball in each frame
+    int16_t *coordinates;       // ring allocated once, never grows
+    int size;                   // coordinates allocated
+    int ballCount;              // balls in each frame
+    int capacity;               // frames that fit
+    int first;                  // oldest frame kept
+    int count;
+    float stepDelta;            // simulated time between two frames
+} PositionTrace;
+
+typedef struct PositionTraceView {
+    float frame;                // fractional frame being shown
+    float speed;                // 0.25 to 1 times the real time
+    bool paused;
+} PositionTraceView;
+
+typedef struct TrajectoryPath {
+    Vector2 points[6];          // start, up to 4 cushion bounces, end
+    int pointCount;
+    bool pocketed;              // the path ends in a pocket
+} TrajectoryPath;
+
 typedef struct TrajectoryPrediction {
     bool willHitBall;
     int ballIndex;
     Vector2 hitPoint;
-    Vector2 cueBallStopPoint;
+    Vector2 cueBallStopPoint;   // cue ball center at the impact or at the end
     Vector2 targetBallDirection;
-    float targetBallSpeed;
+    float targetBallSpeed;      // right after the impact
+    TrajectoryPath cueBallPath;
+    TrajectoryPath targetBallPath;
 } TrajectoryPrediction;
+
+typedef struct TrajectoryCache {
+    // the prediction is only computed again when one of these changes
+    bool valid;
+    float angle;
+    int power;
+    Vector2 hitPoint;
+    Vector2 centers[BALL_CAPACITY];
+    bool pocketed[BALL_CAPACITY];
+    TrajectoryPrediction prediction;
+} TrajectoryCache;
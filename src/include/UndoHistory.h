@@ -0,0 +1,58 @@
+/**
+ * @file UndoHistory.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Undo history function declarations. The table is captured as a
+ * game snapshot before each shot, in a ring allocated once, so shots can be
+ * undone and redone without simulating anything.
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "Types.h"
+
+#define UNDO_HISTORY_CAPACITY 256
+
+/**
+ * @brief Allocates room for capacity snapshots (at least 2).
+ */
+void setupUndoHistory( UndoHistory *h, int capacity );
+
+/**
+ * @brief Frees the snapshots of the history.
+ */
+void destroyUndoHistory( UndoHistory *h );
+
+/**
+ * @brief Forgets every snapshot, keeping the memory.
+ */
+void clearUndoHistory( UndoHistory *h );
+
+/**
+ * @brief Captures gw right before a shot, with the length of the match
+ * replay at that moment. The shots undone so far can't be redone anymore and
+ * the oldest snapshot is dropped when the history is full.
+ */
+void pushUndoHistory( UndoHistory *h, const GameWorld *gw, int replayLength );
+
+/**
+ * @brief Puts gw back in the state before the last shot. replayLength gives
+ * the current length of the match replay and receives the one to cut it to.
+ * Returns false if there is nothing to undo.
+ */
+bool undoGameWorld( UndoHistory *h, GameWorld *gw, int *replayLength );
+
+/**
+ * @brief Puts gw back in the state after the last shot undone. replayLength
+ * receives the length of the match replay to grow it back to. Returns false
+ * if there is nothing to redo.
+ */
+bool redoGameWorld( UndoHistory *h, GameWorld *gw, int *replayLength );
+
+/**
+ * @brief Forgets the shots undone so far, when the table changed after them.
+ */
+void discardRedoHistory( UndoHistory *h );